@@ -0,0 +1,24 @@
+/**
+ * Benchmark
+ * ofxTimeline
+ *
+ * Times the sampling, loading, undo and preview paths of the timeline tracks
+ * across a range of keyframe counts, prints the results and saves them as json
+ */
+
+#include "ofMain.h"
+#include "testApp.h"
+#include "ofAppGlutWindow.h"
+
+//========================================================================
+int main( ){
+
+    ofAppGlutWindow window;
+	ofSetupOpenGL(&window, 1024,768, OF_WINDOW);			// <-------- setup the GL context
+
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp( new testApp());
+
+}
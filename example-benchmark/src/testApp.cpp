@@ -0,0 +1,687 @@
+/**
+ * Benchmark
+ * ofxTimeline
+ *
+ * Times the sampling, loading, undo and preview paths of the timeline tracks
+ * across a range of keyframe counts, prints the results and saves them as json.
+ * The fast sampling paths are also checked against the math they replaced
+ */
+
+#include "testApp.h"
+#include <cassert>
+
+#define NUM_SAMPLES 100000
+
+#ifdef TARGET_LINUX
+//the kernel's high water mark of resident memory, in kb
+static long getPeakMemoryKB(){
+	ifstream status("/proc/self/status");
+	string line;
+	while(getline(status, line)){
+		if(line.compare(0, 6, "VmHWM:") == 0){
+			return ofToInt(line.substr(6));
+		}
+	}
+	return 0;
+}
+
+//brings the high water mark down to the current resident memory so the next load is measured on its own
+static void resetPeakMemory(){
+	ofstream clearRefs("/proc/self/clear_refs");
+	clearRefs << "5";
+}
+#else
+//peak memory is only measured on linux
+static long getPeakMemoryKB(){
+	return 0;
+}
+static void resetPeakMemory(){
+}
+#endif
+
+//the search ofxTLKeyframes::sampleAtTime used before the binary search, for comparison
+//scans from the first key on every call that isn't moving forward in time
+static float linearScanValue(vector<ofxTLKeyframe*>& keys, unsigned long long sampleTime){
+	if(sampleTime <= keys[0]->time) return keys[0]->value;
+	if(sampleTime >= keys[keys.size()-1]->time) return keys[keys.size()-1]->value;
+	for(int i = 1; i < keys.size(); i++){
+		if(keys[i]->time >= sampleTime){
+			return ofMap(sampleTime, keys[i-1]->time, keys[i]->time, keys[i-1]->value, keys[i]->value);
+		}
+	}
+	return 0;
+}
+
+//the scan ofxTLSwitches::isOnAtMillis did before the interval index, for comparison
+static bool linearScanSwitches(vector<ofxTLKeyframe*>& keys, long millis){
+	for(int i = 0; i < keys.size(); i++){
+		ofxTLSwitch* switchKey = (ofxTLSwitch*)keys[i];
+		if(switchKey->timeRange.min > millis) break;
+		if(switchKey->timeRange.contains(millis)) return true;
+	}
+	return false;
+}
+
+//--------------------------------------------------------------
+void testApp::setup(){
+	
+	ofSetFrameRate(60);
+	ofSetVerticalSync(true);
+	ofBackground(.15*255);
+	
+	timeline.setup();
+	//keep the benchmark from writing xml files or undo states for every key added
+	timeline.setAutosave(false);
+	timeline.enableUndo(false);
+	timeline.setDurationInSeconds(60*60);
+	timeline.setShowTimeControls(false);
+	
+	runBenchmarks();
+}
+
+void testApp::runBenchmarks(){
+	results.clear();
+	ofLogNotice("Benchmark") << "test, keys, samples, total micros, nanos per sample";
+	
+	int keyCounts[] = { 10, 100, 1000, 10000, 100000, 1000000 };
+	for(int i = 0; i < 6; i++){
+		benchmarkSampling(keyCounts[i]);
+		benchmarkThreadedSampling(keyCounts[i], 4);
+		benchmarkSwitches(keyCounts[i]);
+		benchmarkColors(keyCounts[i]);
+		benchmarkBangs(keyCounts[i]);
+		benchmarkSortAndPreviews(keyCounts[i]);
+		benchmarkLFO(keyCounts[i]);
+		//reloading and undo copy whole tracks, a million keys takes minutes without telling us more
+		if(keyCounts[i] <= 100000){
+			benchmarkReload(keyCounts[i]);
+			benchmarkUndo(keyCounts[i]);
+		}
+	}
+	benchmarkXmlLoad(100000);
+	benchmarkLFOXmlLoad(100000);
+	benchmarkEasing();
+	saveResults("benchmark_results.json");
+}
+
+void testApp::benchmarkSampling(int numKeys){
+	
+	BenchmarkCurves* curves = addBenchmarkCurves("sampling " + ofToString(numKeys), numKeys);
+	unsigned long long duration = timeline.getDurationInMilliseconds();
+	
+	vector<unsigned long long> forwardTimes;
+	vector<unsigned long long> randomTimes;
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		forwardTimes.push_back(i * duration / NUM_SAMPLES);
+		randomTimes.push_back(ofRandom(duration));
+	}
+	
+	//accumulate the values so the calls can't be optimized out
+	float sum = 0;
+	unsigned long long startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		sum += curves->getValueAtTimeInMillis(forwardTimes[i]);
+	}
+	report("sampleAtTime forward playback", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+	
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = NUM_SAMPLES-1; i >= 0; i--){
+		sum += curves->getValueAtTimeInMillis(forwardTimes[i]);
+	}
+	report("sampleAtTime backward scrub", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		sum += curves->getValueAtTimeInMillis(randomTimes[i]);
+	}
+	report("sampleAtTime random access", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+
+	ofxTLKeyframeCursor cursor;
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		sum += curves->getValueAtTimeInMillis(forwardTimes[i], &cursor);
+	}
+	report("cursor forward playback", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		sum += curves->getValueAtTimeInMillis(randomTimes[i], NULL);
+	}
+	report("no cursor random access", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+
+	//same times as forward playback, filled in one call
+	vector<float> batch(NUM_SAMPLES);
+	startTime = ofGetElapsedTimeMicros();
+	curves->getValuesInRange(forwardTimes[0], forwardTimes[NUM_SAMPLES-1], NUM_SAMPLES, &batch[0]);
+	report("getValuesInRange", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+	sum += batch[NUM_SAMPLES/2];
+
+	//the linear scan is too slow to run the full sample count on large tracks
+	int linearSamples = MIN(NUM_SAMPLES, 100000000 / numKeys);
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < linearSamples; i++){
+		sum += linearScanValue(curves->getKeyframes(), randomTimes[i]);
+	}
+	report("linear scan random access", numKeys, linearSamples, ofGetElapsedTimeMicros() - startTime);
+	
+	ofLogVerbose("Benchmark") << "checksum " << sum;
+	removeBenchmarkTrack(curves);
+}
+
+//every thread samples the same track at once, each with its own cursor
+void testApp::benchmarkThreadedSampling(int numKeys, int numThreads){
+	
+	BenchmarkCurves* curves = addBenchmarkCurves("threaded " + ofToString(numKeys), numKeys);
+	unsigned long long duration = timeline.getDurationInMilliseconds();
+	
+	vector<unsigned long long> forwardTimes;
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		forwardTimes.push_back(i * duration / NUM_SAMPLES);
+	}
+	
+	vector<SamplingThread*> threads;
+	for(int i = 0; i < numThreads; i++){
+		SamplingThread* thread = new SamplingThread();
+		thread->curves = curves;
+		thread->sampleTimes = &forwardTimes;
+		threads.push_back(thread);
+	}
+	
+	unsigned long long startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < numThreads; i++){
+		threads[i]->startThread(false, false);
+	}
+	float sum = 0;
+	for(int i = 0; i < numThreads; i++){
+		threads[i]->waitForThread(false);
+		sum += threads[i]->sum;
+	}
+	report(ofToString(numThreads) + " threads forward playback", numKeys, NUM_SAMPLES*numThreads, ofGetElapsedTimeMicros() - startTime);
+	
+	for(int i = 0; i < numThreads; i++){
+		delete threads[i];
+	}
+	
+	ofLogVerbose("Benchmark") << "checksum " << sum;
+	removeBenchmarkTrack(curves);
+}
+
+//reloads the track from xml the way undo does, reusing the keyframes' memory from the track's pool
+//then from its binary file, read into keyframes and then memory mapped
+void testApp::benchmarkReload(int numKeys){
+	
+	BenchmarkCurves* curves = addBenchmarkCurves("reload " + ofToString(numKeys), numKeys);
+	string state = curves->getXMLRepresentation();
+	
+	int numReloads = 5;
+	unsigned long long startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < numReloads; i++){
+		curves->loadFromXMLRepresentation(state);
+	}
+	report("reload from xml", numKeys, numReloads, ofGetElapsedTimeMicros() - startTime);
+
+	curves->useBinarySave = true;
+	curves->saveToBinaryFile();
+
+	curves->useMappedLoading = false;
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < numReloads; i++){
+		curves->loadFromBinaryFile();
+	}
+	report("reload from binary", numKeys, numReloads, ofGetElapsedTimeMicros() - startTime);
+
+	//only tracks over OFXTL_MIN_MAPPED_KEYS stay mapped, smaller ones are read out of the mapping
+	curves->useMappedLoading = true;
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < numReloads; i++){
+		curves->loadFromBinaryFile();
+	}
+	report("reload mapped binary", numKeys, numReloads, ofGetElapsedTimeMicros() - startTime);
+
+	//first pass over a freshly mapped track pages the columns in
+	float sum = 0;
+	unsigned long long duration = timeline.getDurationInMilliseconds();
+	ofxTLKeyframeCursor cursor;
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		sum += curves->getValueAtTimeInMillis(i * duration / NUM_SAMPLES, &cursor);
+	}
+	report(curves->isMapped() ? "mapped forward playback" : "loaded forward playback", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+	ofLogVerbose("Benchmark") << "checksum " << sum;
+
+	const ofxTLKeyframePool& pool = curves->getKeyframePool();
+	ofLogNotice("Benchmark") << "keyframe pool: " << pool.getNumAllocations() << " allocations, "
+							 << pool.getNumHeapAllocations() << " from the heap, "
+							 << pool.getReservedBytes() << " bytes reserved";
+	removeBenchmarkTrack(curves);
+}
+
+//loads a saved curves file through an xml document, then by reading the text directly
+void testApp::benchmarkXmlLoad(int numKeys){
+	
+	BenchmarkCurves* curves = addBenchmarkCurves("xml load " + ofToString(numKeys), numKeys);
+	curves->useBinarySave = false;
+	curves->save();
+	
+	curves->clear();
+	resetPeakMemory();
+	long startMemory = getPeakMemoryKB();
+	unsigned long long startTime = ofGetElapsedTimeMicros();
+	curves->loadWithDocument();
+	report("load xml document", numKeys, numKeys, ofGetElapsedTimeMicros() - startTime);
+	ofLogNotice("Benchmark") << "load xml document peak memory: " << (getPeakMemoryKB() - startMemory) << " kb";
+	
+	curves->clear();
+	resetPeakMemory();
+	startMemory = getPeakMemoryKB();
+	startTime = ofGetElapsedTimeMicros();
+	curves->load();
+	report("load xml text", numKeys, numKeys, ofGetElapsedTimeMicros() - startTime);
+	ofLogNotice("Benchmark") << "load xml text peak memory: " << (getPeakMemoryKB() - startMemory) << " kb";
+	
+	removeBenchmarkTrack(curves);
+}
+
+//the same for an lfo, which restores eight values a key where curves restore two
+void testApp::benchmarkLFOXmlLoad(int numKeys){
+	
+	string name = "lfo xml load " + ofToString(numKeys);
+	BenchmarkLFO* lfo = new BenchmarkLFO();
+	lfo->setXMLFileName(timeline.getXMLFileNameFor(name));
+	timeline.addTrack(name, lfo);
+	unsigned long long duration = timeline.getDurationInMilliseconds();
+	for(int i = 0; i < numKeys; i++){
+		lfo->addKeyframeAtMillis(ofRandomuf(), i * duration / numKeys);
+	}
+	lfo->save();
+	
+	lfo->clear();
+	unsigned long long startTime = ofGetElapsedTimeMicros();
+	lfo->loadWithDocument();
+	report("lfo load xml document", numKeys, numKeys, ofGetElapsedTimeMicros() - startTime);
+	
+	lfo->clear();
+	startTime = ofGetElapsedTimeMicros();
+	lfo->load();
+	report("lfo load xml text", numKeys, numKeys, ofGetElapsedTimeMicros() - startTime);
+	
+	removeBenchmarkTrack(lfo);
+}
+
+//non overlapping switches, each on for half the gap to the next
+void testApp::benchmarkSwitches(int numKeys){
+	
+	BenchmarkSwitches* switches = new BenchmarkSwitches();
+	timeline.addTrack("switches " + ofToString(numKeys), switches);
+	unsigned long long duration = timeline.getDurationInMilliseconds();
+	unsigned long long gap = duration / numKeys;
+	for(int i = 0; i < numKeys; i++){
+		switches->addSwitch(i * gap, i * gap + gap/2);
+	}
+	switches->finishedAdding();
+	
+	vector<unsigned long long> forwardTimes;
+	vector<unsigned long long> randomTimes;
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		forwardTimes.push_back(i * duration / NUM_SAMPLES);
+		randomTimes.push_back(ofRandom(duration));
+	}
+	
+	int numOn = 0;
+	unsigned long long startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		numOn += switches->isOnAtMillis(forwardTimes[i]);
+	}
+	report("isOnAtMillis forward playback", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+	
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		numOn += switches->isOnAtMillis(randomTimes[i]);
+	}
+	report("isOnAtMillis random access", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+	
+	int linearSamples = MIN(NUM_SAMPLES, 100000000 / numKeys);
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < linearSamples; i++){
+		numOn += linearScanSwitches(switches->getKeyframes(), randomTimes[i]);
+	}
+	report("switches linear scan random access", numKeys, linearSamples, ofGetElapsedTimeMicros() - startTime);
+	
+	//a second of look ahead at a time, the way a scheduler would ask
+	vector<ofxTLSwitchTransition> transitions;
+	int numWindows = MIN(NUM_SAMPLES, (int)(duration / 1000));
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < numWindows; i++){
+		switches->getTransitionsInRange(i * 1000, i * 1000 + 999, transitions);
+		numOn += transitions.size();
+	}
+	report("getTransitionsInRange one second windows", numKeys, numWindows, ofGetElapsedTimeMicros() - startTime);
+	
+	ofLogVerbose("Benchmark") << "checksum " << numOn;
+	removeBenchmarkTrack(switches);
+}
+
+void testApp::benchmarkColors(int numKeys){
+	
+	ofxTLColorTrack* colors = timeline.addColors("colors " + ofToString(numKeys));
+	unsigned long long duration = timeline.getDurationInMilliseconds();
+	for(int i = 0; i < numKeys; i++){
+		colors->addKeyframeAtMillis(ofRandomuf(), i * duration / numKeys);
+	}
+	
+	vector<unsigned long long> randomTimes;
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		randomTimes.push_back(ofRandom(duration));
+	}
+	
+	int sum = 0;
+	ofxTLKeyframeCursor cursor;
+	unsigned long long startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		sum += colors->getColorAtMillis(i * duration / NUM_SAMPLES, &cursor).r;
+	}
+	report("getColorAtMillis forward playback", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+	
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		sum += colors->getColorAtMillis(randomTimes[i]).r;
+	}
+	report("getColorAtMillis random access", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+	
+	vector<unsigned char> rgba(NUM_SAMPLES*4);
+	startTime = ofGetElapsedTimeMicros();
+	colors->getColorsInRange(0, duration, NUM_SAMPLES, &rgba[0]);
+	report("getColorsInRange whole track", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+	sum += rgba[NUM_SAMPLES*2];
+	
+	ofLogVerbose("Benchmark") << "checksum " << sum;
+	removeBenchmarkTrack(colors);
+}
+
+//plays through the whole track a frame at a time, sending every bang on the way
+void testApp::benchmarkBangs(int numKeys){
+	
+	ofxTLBangs* bangs = timeline.addBangs("bangs " + ofToString(numKeys));
+	unsigned long long duration = timeline.getDurationInMilliseconds();
+	for(int i = 0; i < numKeys; i++){
+		bangs->addKeyframeAtMillis(i * duration / numKeys);
+	}
+	
+	ofxTLTrack* track = bangs;
+	int numUpdates = MIN(NUM_SAMPLES, (int)(duration / 16));
+	timeline.setCurrentTimeMillis(0);
+	track->update();
+	unsigned long long startTime = ofGetElapsedTimeMicros();
+	for(int i = 1; i <= numUpdates; i++){
+		timeline.setCurrentTimeMillis(i * duration / numUpdates);
+		track->update();
+	}
+	report("bangs update playback", numKeys, numUpdates, ofGetElapsedTimeMicros() - startTime);
+	
+	timeline.setCurrentTimeMillis(0);
+	removeBenchmarkTrack(bangs);
+}
+
+void testApp::benchmarkSortAndPreviews(int numKeys){
+	
+	BenchmarkCurves* curves = addBenchmarkCurves("sort " + ofToString(numKeys), numKeys);
+	
+	unsigned long long startTime = ofGetElapsedTimeMicros();
+	curves->updateKeyframeSort();
+	report("updateKeyframeSort already sorted", numKeys, 1, ofGetElapsedTimeMicros() - startTime);
+	
+	curves->scatterKeys(100);
+	startTime = ofGetElapsedTimeMicros();
+	curves->updateKeyframeSort();
+	report("updateKeyframeSort one percent moved", numKeys, 1, ofGetElapsedTimeMicros() - startTime);
+	
+	//the whole track on screen, then zoomed in on the first percent
+	int numRecomputes = 10;
+	timeline.getZoomer()->setViewRange(ofRange(0, 1.0));
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < numRecomputes; i++){
+		curves->recomputePreviews();
+	}
+	report("recomputePreviews whole track", numKeys, numRecomputes, ofGetElapsedTimeMicros() - startTime);
+	
+	timeline.getZoomer()->setViewRange(ofRange(0, .01));
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < numRecomputes; i++){
+		curves->recomputePreviews();
+	}
+	report("recomputePreviews zoomed in", numKeys, numRecomputes, ofGetElapsedTimeMicros() - startTime);
+	timeline.getZoomer()->setViewRange(ofRange(0, 1.0));
+	
+	removeBenchmarkTrack(curves);
+}
+
+//one key added per edit, the way a click would, recorded for undo
+//curves keep deltas of the keys an edit touched, switches still store the whole track as xml
+void testApp::benchmarkUndo(int numKeys){
+	
+	timeline.enableUndo(true);
+	//every edit gets its own step rather than being folded into the last one
+	timeline.setUndoCoalesceMillis(0);
+	unsigned long long duration = timeline.getDurationInMilliseconds();
+	int numEdits = 20;
+	
+	BenchmarkCurves* curves = addBenchmarkCurves("undo curves " + ofToString(numKeys), numKeys);
+	curves->selectAll();
+	unsigned long long startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < numEdits; i++){
+		timeline.beginEdit();
+		curves->addKeyframeAtMillis(ofRandomuf(), ofRandom(duration));
+		timeline.endEdit();
+	}
+	report("collectStateBuffers and pushUndoStack curves", numKeys, numEdits, ofGetElapsedTimeMicros() - startTime);
+	
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < numEdits; i++){
+		timeline.undo();
+	}
+	report("undo curves", numKeys, numEdits, ofGetElapsedTimeMicros() - startTime);
+	ofLogNotice("Benchmark") << "undo memory for " << numKeys << " curves keys: " << timeline.getUndoMemoryUsage() << " bytes";
+	removeBenchmarkTrack(curves);
+	
+	BenchmarkSwitches* switches = new BenchmarkSwitches();
+	timeline.addTrack("undo switches " + ofToString(numKeys), switches);
+	unsigned long long gap = duration / numKeys;
+	for(int i = 0; i < numKeys; i++){
+		switches->addSwitch(i * gap, i * gap + gap/2);
+	}
+	switches->finishedAdding();
+	switches->selectAll();
+	startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < numEdits; i++){
+		timeline.beginEdit();
+		timeline.flagTrackModified(switches);
+		timeline.endEdit();
+	}
+	report("collectStateBuffers and pushUndoStack switches", numKeys, numEdits, ofGetElapsedTimeMicros() - startTime);
+	removeBenchmarkTrack(switches);
+	
+	timeline.enableUndo(false);
+}
+
+//a millisecond apart either way, one sample at a time against filling a buffer the way an audio callback would
+void testApp::benchmarkLFO(int numKeys){
+	
+	ofxTLLFO* lfo = timeline.addLFO("lfo " + ofToString(numKeys));
+	unsigned long long duration = timeline.getDurationInMilliseconds();
+	for(int i = 0; i < numKeys; i++){
+		lfo->addKeyframeAtMillis(ofRandomuf(), i * duration / numKeys);
+	}
+	
+	float sum = 0;
+	ofxTLKeyframeCursor cursor;
+	unsigned long long startTime = ofGetElapsedTimeMicros();
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		sum += lfo->getValueAtTimeInMillis(i, &cursor);
+	}
+	report("lfo getValueAtTimeInMillis forward playback", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+	
+	vector<float> values(NUM_SAMPLES);
+	startTime = ofGetElapsedTimeMicros();
+	lfo->getValuesAtRate(0, 1000, NUM_SAMPLES, &values[0]);
+	report("lfo getValuesAtRate", numKeys, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+	sum += values[NUM_SAMPLES/2];
+	
+	//the rotating phase against the cos a sample it replaced, over the same hundred seconds
+	//the buffer drifts from the single sample math with frequency and time, see ofxTLLFO.cpp
+	float maxError = 0;
+	ofxTLKeyframeCursor checkCursor;
+	for(int i = 0; i < NUM_SAMPLES; i++){
+		maxError = MAX(maxError, fabs(values[i] - lfo->getValueAtTimeInMillis(i, &checkCursor)));
+	}
+	ofRange valueRange = lfo->getValueRange();
+	checkAccuracy("lfo getValuesAtRate " + ofToString(numKeys) + " keys", maxError, 1e-3 * (valueRange.max - valueRange.min));
+	
+	ofLogVerbose("Benchmark") << "checksum " << sum;
+	removeBenchmarkTrack(lfo);
+}
+
+//one segment eased in and out, sampled through ofxTween the way curves used to
+//against the kernels one sample at a time and a run at a time, then checked against it for every easing
+void testApp::benchmarkEasing(){
+	
+	ofxEasingCubic cubic;
+	ofxEasingBack back;
+	ofxEasingBounce bounce;
+	ofxEasingElastic elastic;
+	ofxEasing* easings[] = { &cubic, &back, &bounce, &elastic };
+	ofxTLEasingKernels kernels[] = {
+		ofxTLMakeEasingKernels<ofxTLEasingCubic>(),
+		ofxTLMakeEasingKernels<ofxTLEasingBack>(),
+		ofxTLMakeEasingKernels<ofxTLEasingBounce>(),
+		ofxTLMakeEasingKernels<ofxTLEasingElastic>()
+	};
+	string names[] = { "cubic", "back", "bounce", "elastic" };
+	
+	float duration = NUM_SAMPLES;
+	vector<float> samples(NUM_SAMPLES);
+	float sum = 0;
+	for(int e = 0; e < 4; e++){
+		unsigned long long startTime = ofGetElapsedTimeMicros();
+		for(int i = 0; i < NUM_SAMPLES; i++){
+			samples[i] = ofxTween::map(i, 0, duration, .25, .75, false, *easings[e], ofxTween::easeInOut);
+		}
+		report("ofxTween::map " + names[e], 2, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+		sum += samples[NUM_SAMPLES/3];
+		
+		ofxTLEaseFunction ease = kernels[e].ease[ofxTween::easeInOut];
+		startTime = ofGetElapsedTimeMicros();
+		for(int i = 0; i < NUM_SAMPLES; i++){
+			samples[i] = .25 + .5 * ease(i / duration);
+		}
+		report("easing kernel per sample " + names[e], 2, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+		sum += samples[NUM_SAMPLES/3];
+		
+		startTime = ofGetElapsedTimeMicros();
+		kernels[e].easeRun[ofxTween::easeInOut](0, 1 / duration, NUM_SAMPLES, .25, .5, &samples[0]);
+		report("easing kernel run " + names[e], 2, NUM_SAMPLES, ofGetElapsedTimeMicros() - startTime);
+		sum += samples[NUM_SAMPLES/3];
+	}
+	ofLogVerbose("Benchmark") << "checksum " << sum;
+	
+	//every easing curves offer, each way, against the ofxTween easing it replaced
+	BenchmarkCurves* curves = addBenchmarkCurves("easing check", 0);
+	vector<EasingFunction*>& easingFunctions = curves->getEasingFunctions();
+	const int numChecks = 1000;
+	vector<float> run(numChecks);
+	string typeNames[] = { "in", "out", "in out" };
+	for(int e = 0; e < easingFunctions.size(); e++){
+		for(int type = ofxTween::easeIn; type <= ofxTween::easeInOut; type++){
+			ofxTween::ofxEasingType easeType = (ofxTween::ofxEasingType)type;
+			easingFunctions[e]->kernels.easeRun[type](0, 1.0 / (numChecks-1), numChecks, .25, .5, &run[0]);
+			float maxError = 0;
+			for(int i = 0; i < numChecks; i++){
+				float tweened = ofxTween::map(i, 0, numChecks-1, .25, .75, false, *easingFunctions[e]->easing, easeType);
+				float sampled = .25 + .5 * easingFunctions[e]->kernels.ease[type](i / float(numChecks-1));
+				maxError = MAX(maxError, MAX(fabs(sampled - tweened), fabs(run[i] - tweened)));
+			}
+			checkAccuracy("easing kernel " + easingFunctions[e]->name + " " + typeNames[type], maxError, 1e-4);
+		}
+	}
+	removeBenchmarkTrack(curves);
+}
+
+BenchmarkCurves* testApp::addBenchmarkCurves(string name, int numKeys){
+	BenchmarkCurves* curves = new BenchmarkCurves();
+	curves->setXMLFileName(timeline.getXMLFileNameFor(name));
+	timeline.addTrack(name, curves);
+	unsigned long long duration = timeline.getDurationInMilliseconds();
+	for(int i = 0; i < numKeys; i++){
+		curves->addKeyframeAtMillis(ofRandomuf(), i * duration / numKeys);
+	}
+	return curves;
+}
+
+void testApp::removeBenchmarkTrack(ofxTLTrack* track){
+	timeline.removeTrack(track);
+	delete track;
+}
+
+void testApp::report(string name, int numKeys, int numSamples, unsigned long long micros){
+	ofLogNotice("Benchmark") << name << ", " << numKeys << ", " << numSamples << ", " << micros << ", " << ofToString(1000.0 * micros / numSamples, 1);
+	BenchmarkResult result;
+	result.test = name;
+	result.keys = numKeys;
+	result.samples = numSamples;
+	result.micros = micros;
+	results.push_back(result);
+}
+
+void testApp::checkAccuracy(string name, float maxError, float tolerance){
+	if(maxError > tolerance){
+		ofLogError("Benchmark") << name << " max error " << maxError << " is over the tolerance of " << tolerance;
+	}
+	else{
+		ofLogNotice("Benchmark") << name << " max error " << maxError << ", within " << tolerance;
+	}
+	assert(maxError <= tolerance);
+}
+
+void testApp::saveResults(string path){
+	ofstream json(ofToDataPath(path).c_str());
+	json << "{" << endl;
+	json << "\t\"date\": \"" << ofGetYear() << "-" << ofToString(ofGetMonth(), 2, '0') << "-" << ofToString(ofGetDay(), 2, '0') << " "
+		 << ofToString(ofGetHours(), 2, '0') << ":" << ofToString(ofGetMinutes(), 2, '0') << ":" << ofToString(ofGetSeconds(), 2, '0') << "\"," << endl;
+	json << "\t\"results\": [" << endl;
+	for(int i = 0; i < results.size(); i++){
+		json << "\t\t{ \"test\": \"" << results[i].test << "\", "
+			 << "\"keys\": " << results[i].keys << ", "
+			 << "\"samples\": " << results[i].samples << ", "
+			 << "\"micros\": " << results[i].micros << ", "
+			 << "\"nanosPerSample\": " << ofToString(1000.0 * results[i].micros / results[i].samples, 1) << " }"
+			 << (i+1 < results.size() ? "," : "") << endl;
+	}
+	json << "\t]" << endl;
+	json << "}" << endl;
+	ofLogNotice("Benchmark") << "saved results to " << ofToDataPath(path);
+}
+
+//--------------------------------------------------------------
+void testApp::update(){
+
+}
+
+//--------------------------------------------------------------
+void testApp::draw(){
+	ofSetColor(255);
+	ofDrawBitmapString("test, keys, samples, total micros, nanos per sample", 20, 30);
+	//the latest results that fit on screen
+	int firstShown = MAX(0, (int)results.size() - (ofGetHeight() - 100) / 15);
+	for(int i = firstShown; i < results.size(); i++){
+		ofDrawBitmapString(results[i].test + ", " + ofToString(results[i].keys) + ", " + ofToString(results[i].samples) + ", " +
+						   ofToString(results[i].micros) + ", " + ofToString(1000.0 * results[i].micros / results[i].samples, 1),
+						   20, 50 + (i-firstShown)*15);
+	}
+	ofDrawBitmapString("press 'r' to run again", 20, 70 + (results.size()-firstShown)*15);
+}
+
+//--------------------------------------------------------------
+void testApp::keyPressed(int key){
+	if(key == 'r'){
+		runBenchmarks();
+	}
+}
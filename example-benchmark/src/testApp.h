@@ -0,0 +1,147 @@
+/**
+ * Benchmark
+ * ofxTimeline
+ *
+ * Times the sampling, loading, undo and preview paths of the timeline tracks
+ * across a range of keyframe counts, prints the results and saves them as json.
+ * The fast sampling paths are also checked against the math they replaced
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxTimeline.h"
+
+//samples a track from its own thread through the const cursor api
+class SamplingThread : public ofThread {
+  public:
+	ofxTLCurves* curves;
+	vector<unsigned long long>* sampleTimes;
+	float sum;
+	
+	void threadedFunction(){
+		ofxTLKeyframeCursor cursor;
+		sum = 0;
+		for(int i = 0; i < sampleTimes->size(); i++){
+			sum += curves->getValueAtTimeInMillis((*sampleTimes)[i], &cursor);
+		}
+	}
+};
+
+//curves that expose the protected paths the benchmark times,
+//and can also load the way they did before the xml was read as text
+class BenchmarkCurves : public ofxTLCurves {
+  public:
+	void loadWithDocument(){
+		clear();
+		ofxXmlSettings savedkeyframes;
+		savedkeyframes.loadFile(xmlFileName);
+		//createKeyframesFromXML used to take its document by value
+		ofxXmlSettings copiedKeyframes = savedkeyframes;
+		createKeyframesFromXML(copiedKeyframes, keyframes);
+		updateKeyframeSort();
+	}
+	void recomputePreviews(){
+		ofxTLCurves::recomputePreviews();
+	}
+	void updateKeyframeSort(){
+		ofxTLCurves::updateKeyframeSort();
+	}
+	//every easing the track offers, with the ofxTween easing it used to sample through
+	vector<EasingFunction*>& getEasingFunctions(){
+		return easingFunctions;
+	}
+	//moves every nth key to a random time, like a drag across the track would
+	void scatterKeys(int everyNth){
+		unsigned long long duration = timeline->getDurationInMilliseconds();
+		for(int i = 0; i < keyframes.size(); i += everyNth){
+			keyframes[i]->time = ofRandom(duration);
+		}
+	}
+};
+
+//an lfo that can load through an xml document too, to check tracks other than curves skip it
+class BenchmarkLFO : public ofxTLLFO {
+  public:
+	void loadWithDocument(){
+		clear();
+		ofxXmlSettings savedkeyframes;
+		savedkeyframes.loadFile(xmlFileName);
+		createKeyframesFromXML(savedkeyframes, keyframes);
+		updateKeyframeSort();
+	}
+};
+
+//switches that can be added without the mouse
+class BenchmarkSwitches : public ofxTLSwitches {
+  public:
+	void addSwitch(unsigned long long startMillis, unsigned long long endMillis){
+		ofxTLSwitch* switchKey = (ofxTLSwitch*)newKeyframe();
+		switchKey->time = switchKey->timeRange.min = startMillis;
+		switchKey->timeRange.max = endMillis;
+		switchKey->endSelected = false;
+		keyframes.push_back(switchKey);
+	}
+	void finishedAdding(){
+		updateKeyframeSort();
+	}
+};
+
+//exposes the undo steps a mouse edit goes through
+class BenchmarkTimeline : public ofxTimeline {
+  public:
+	void beginEdit(){
+		collectStateBuffers();
+	}
+	void endEdit(){
+		pushUndoStack();
+	}
+	//the file addCurves() would have given a track with this name
+	string getXMLFileNameFor(string name){
+		return nameToXMLName(name);
+	}
+};
+
+typedef struct {
+	string test;
+	int keys;
+	int samples;
+	unsigned long long micros;
+} BenchmarkResult;
+
+class testApp : public ofBaseApp{
+
+  public:
+	void setup();
+	void update();
+	void draw();
+
+	void keyPressed  (int key);
+	
+	void runBenchmarks();
+	void benchmarkSampling(int numKeys);
+	void benchmarkThreadedSampling(int numKeys, int numThreads);
+	void benchmarkReload(int numKeys);
+	void benchmarkXmlLoad(int numKeys);
+	void benchmarkLFOXmlLoad(int numKeys);
+	void benchmarkSwitches(int numKeys);
+	void benchmarkColors(int numKeys);
+	void benchmarkBangs(int numKeys);
+	void benchmarkSortAndPreviews(int numKeys);
+	void benchmarkUndo(int numKeys);
+	void benchmarkLFO(int numKeys);
+	void benchmarkEasing();
+	
+	//adds a curves track with numKeys evenly spaced random keys
+	BenchmarkCurves* addBenchmarkCurves(string name, int numKeys);
+	//removes and deletes a track the benchmark made itself
+	void removeBenchmarkTrack(ofxTLTrack* track);
+	void report(string name, int numKeys, int numSamples, unsigned long long micros);
+	//logs how far a fast path strayed from the math it replaced, and stops debug builds if it's past tolerance
+	void checkAccuracy(string name, float maxError, float tolerance);
+	//writes every result to bin/data so runs can be compared across releases
+	void saveResults(string path);
+	
+	BenchmarkTimeline timeline;
+	vector<BenchmarkResult> results;
+};
@@ -165,7 +165,8 @@ void testApp::renderCurrentFrame(){
     timeline.getVideoPlayer("Video")->update();
     int videoFrameToRender = timeline.getVideoPlayer("Video")->getCurrentFrame();
     float timeToSetTimeline = timeline.getVideoPlayer("Video")->getPosition() * timeline.getVideoPlayer("Video")->getDuration();
-    timeline.setCurrentFrame(videoFrameToRender);
+    //stepping sends the switches crossed since the last frame, and doesn't depend on the app's frame rate
+    timeline.stepToFrame(videoFrameToRender);
     
     //draw the video with the shader into the frame buffer
     frameBuffer.begin();
@@ -190,6 +191,7 @@ void testApp::renderCurrentFrame(){
     currentRenderFrame++;
     if(currentRenderFrame > timeline.getOutFrame()){
         rendering = false;
+        timeline.endOffline();
         timeline.enable();
 		timeline.setCurrentFrame(timeline.getInFrame());
     }
@@ -223,6 +225,7 @@ void testApp::mousePressed(int x, int y, int button){
 	if(loaded && renderButton.inside(x,y)){
         if(rendering){
             rendering = false;
+            timeline.endOffline();
             timeline.enable();
         }
         else{
@@ -235,7 +238,7 @@ void testApp::mousePressed(int x, int y, int button){
 			rendering = true;
             currentRenderFrame = timeline.getInFrame();
             timeline.getVideoPlayer("Video")->getPlayer()->setFrame(currentRenderFrame);
-            timeline.stop();
+            timeline.beginOffline(timeline.getInTimeInMillis());
             timeline.disable();
         }
     }else if(renderButton.inside(x,y)){
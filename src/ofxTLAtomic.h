@@ -0,0 +1,88 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+//the few atomic operations the lock free queue and snapshots need
+//full barriers are plenty at the rates the timeline ticks
+
+#ifdef TARGET_WIN32
+#include <windows.h>
+#endif
+
+inline bool ofxTLCompareAndSwap(volatile unsigned int* value, unsigned int expected, unsigned int desired){
+#ifdef TARGET_WIN32
+	return InterlockedCompareExchange((volatile LONG*)value, desired, expected) == (LONG)expected;
+#else
+	return __sync_bool_compare_and_swap(value, expected, desired);
+#endif
+}
+
+inline void ofxTLAtomicIncrement(volatile unsigned int* value){
+#ifdef TARGET_WIN32
+	InterlockedIncrement((volatile LONG*)value);
+#else
+	__sync_fetch_and_add(value, 1);
+#endif
+}
+
+//returns the value after the decrement
+inline unsigned int ofxTLAtomicDecrement(volatile unsigned int* value){
+#ifdef TARGET_WIN32
+	return InterlockedDecrement((volatile LONG*)value);
+#else
+	return __sync_sub_and_fetch(value, 1);
+#endif
+}
+
+inline void ofxTLMemoryBarrier(){
+#ifdef TARGET_WIN32
+	MemoryBarrier();
+#else
+	__sync_synchronize();
+#endif
+}
+
+//reads that nothing after them can be moved ahead of
+template<class T>
+inline T ofxTLLoadAcquire(volatile T* value){
+	T loaded = *value;
+	ofxTLMemoryBarrier();
+	return loaded;
+}
+
+//writes that nothing before them can be moved behind
+template<class T>
+inline void ofxTLStoreRelease(volatile T* value, T stored){
+	ofxTLMemoryBarrier();
+	*value = stored;
+}
@@ -0,0 +1,238 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "ofxTLBakedTimeline.h"
+#include "ofxTLBinaryFormat.h"
+
+ofxTLBakedTimeline::ofxTLBakedTimeline()
+:	sampleRate(0),
+	startMillis(0),
+	numSamples(0),
+	currentSample(0)
+{
+	//
+}
+
+bool ofxTLBakedTimeline::load(string path){
+	close();
+	
+	if(!ofxTLBinaryHostIsLittleEndian()){
+		ofLogError("ofxTLBakedTimeline::load") << "baked files can only be read on little endian machines";
+		return false;
+	}
+	if(!file.open(path)){
+		ofLogError("ofxTLBakedTimeline::load") << "couldn't open " << path;
+		return false;
+	}
+	
+	ofxTLBinaryReader reader(file.getData(), file.size());
+	char magic[4];
+	reader.readBytes(magic, 4);
+	unsigned int version = reader.readUInt32();
+	if(!reader.good() || memcmp(magic, OFXTL_BAKED_MAGIC, 4) != 0 || version != OFXTL_BAKED_VERSION){
+		ofLogError("ofxTLBakedTimeline::load") << path << " isn't a baked timeline this version can read";
+		close();
+		return false;
+	}
+	
+	sampleRate = reader.readFloat();
+	startMillis = reader.readUInt64();
+	numSamples = reader.readUInt32();
+	unsigned int numColumns = reader.readUInt32();
+	for(unsigned int i = 0; i < numColumns && reader.good(); i++){
+		Column column;
+		column.name = reader.readString();
+		column.type = reader.readString();
+		column.columnType = (ColumnType)reader.readUInt32();
+		unsigned long long offset = reader.readUInt64();
+		
+		size_t columnSize = 0;
+		switch(column.columnType){
+			case VALUES:	columnSize = numSamples*sizeof(float); break;
+			case SWITCHES:	columnSize = (numSamples+7)/8; break;
+			case COLORS:	columnSize = numSamples*4; break;
+			default:		columnSize = file.size()+1; break;
+		}
+		if(offset % 8 != 0 || offset > file.size() || columnSize > file.size() - offset){
+			ofLogError("ofxTLBakedTimeline::load") << "column " << column.name << " runs past the end of " << path;
+			close();
+			return false;
+		}
+		column.data = file.getData() + offset;
+		trackIndices[column.name] = columns.size();
+		columns.push_back(column);
+	}
+	
+	if(!reader.good() || numSamples <= 0 || sampleRate <= 0){
+		ofLogError("ofxTLBakedTimeline::load") << path << " is cut short";
+		close();
+		return false;
+	}
+	currentSample = 0;
+	return true;
+}
+
+void ofxTLBakedTimeline::close(){
+	file.close();
+	columns.clear();
+	trackIndices.clear();
+	sampleRate = 0;
+	startMillis = 0;
+	numSamples = 0;
+	currentSample = 0;
+}
+
+bool ofxTLBakedTimeline::isLoaded() const{
+	return file.isOpen();
+}
+
+float ofxTLBakedTimeline::getSampleRate() const{
+	return sampleRate;
+}
+
+unsigned long long ofxTLBakedTimeline::getStartMillis() const{
+	return startMillis;
+}
+
+unsigned long long ofxTLBakedTimeline::getDurationInMilliseconds() const{
+	return numSamples > 0 ? (numSamples-1)*1000.0/sampleRate : 0;
+}
+
+int ofxTLBakedTimeline::getNumSamples() const{
+	return numSamples;
+}
+
+int ofxTLBakedTimeline::getNumTracks() const{
+	return columns.size();
+}
+
+bool ofxTLBakedTimeline::hasTrack(const string& name) const{
+	return trackIndices.find(name) != trackIndices.end();
+}
+
+int ofxTLBakedTimeline::getTrackIndex(const string& name) const{
+	map<string, int>::const_iterator it = trackIndices.find(name);
+	return it != trackIndices.end() ? it->second : -1;
+}
+
+string ofxTLBakedTimeline::getTrackName(int trackIndex) const{
+	return columns[trackIndex].name;
+}
+
+string ofxTLBakedTimeline::getTrackType(int trackIndex) const{
+	return columns[trackIndex].type;
+}
+
+ofxTLBakedTimeline::ColumnType ofxTLBakedTimeline::getColumnType(int trackIndex) const{
+	return columns[trackIndex].columnType;
+}
+
+int ofxTLBakedTimeline::getSampleForMillis(double millis) const{
+	double sample = (millis - startMillis) * sampleRate / 1000.0 + .5;
+	return ofClamp(sample, 0, numSamples-1);
+}
+
+float ofxTLBakedTimeline::getValue(int trackIndex, int sample) const{
+	return getValues(trackIndex)[sample];
+}
+
+bool ofxTLBakedTimeline::isSwitchOn(int trackIndex, int sample) const{
+	return (getSwitchBits(trackIndex)[sample >> 3] >> (sample & 7)) & 1;
+}
+
+ofColor ofxTLBakedTimeline::getColor(int trackIndex, int sample) const{
+	const unsigned char* rgba = getColors(trackIndex) + sample*4;
+	return ofColor(rgba[0], rgba[1], rgba[2], rgba[3]);
+}
+
+const float* ofxTLBakedTimeline::getValues(int trackIndex) const{
+	return (const float*)columns[trackIndex].data;
+}
+
+const unsigned char* ofxTLBakedTimeline::getSwitchBits(int trackIndex) const{
+	return (const unsigned char*)columns[trackIndex].data;
+}
+
+const unsigned char* ofxTLBakedTimeline::getColors(int trackIndex) const{
+	return (const unsigned char*)columns[trackIndex].data;
+}
+
+void ofxTLBakedTimeline::setCurrentTimeMillis(unsigned long long millis){
+	currentSample = getSampleForMillis(millis);
+}
+
+void ofxTLBakedTimeline::setCurrentTimeSeconds(float seconds){
+	currentSample = getSampleForMillis(seconds*1000.0);
+}
+
+int ofxTLBakedTimeline::findColumn(const string& name, ColumnType columnType) const{
+	int trackIndex = getTrackIndex(name);
+	if(trackIndex == -1){
+		ofLogError("ofxTLBakedTimeline -- Couldn't find track " + name);
+		return -1;
+	}
+	if(columns[trackIndex].columnType != columnType){
+		ofLogError("ofxTLBakedTimeline -- Track " + name + " is " + columns[trackIndex].type + ", not the type asked for");
+		return -1;
+	}
+	return trackIndex;
+}
+
+float ofxTLBakedTimeline::getValue(const string& name){
+	int trackIndex = findColumn(name, VALUES);
+	return trackIndex != -1 ? getValue(trackIndex, currentSample) : 0.0;
+}
+
+bool ofxTLBakedTimeline::isSwitchOn(const string& name){
+	int trackIndex = findColumn(name, SWITCHES);
+	return trackIndex != -1 ? isSwitchOn(trackIndex, currentSample) : false;
+}
+
+ofColor ofxTLBakedTimeline::getColor(const string& name){
+	int trackIndex = findColumn(name, COLORS);
+	return trackIndex != -1 ? getColor(trackIndex, currentSample) : ofColor(0,0,0);
+}
+
+float ofxTLBakedTimeline::getValue(const string& name, float atTime){
+	int trackIndex = findColumn(name, VALUES);
+	return trackIndex != -1 ? getValue(trackIndex, getSampleForMillis(atTime*1000.0)) : 0.0;
+}
+
+bool ofxTLBakedTimeline::isSwitchOn(const string& name, float atTime){
+	int trackIndex = findColumn(name, SWITCHES);
+	return trackIndex != -1 ? isSwitchOn(trackIndex, getSampleForMillis(atTime*1000.0)) : false;
+}
+
+ofColor ofxTLBakedTimeline::getColorAtMillis(const string& name, unsigned long long millis){
+	int trackIndex = findColumn(name, COLORS);
+	return trackIndex != -1 ? getColor(trackIndex, getSampleForMillis(millis)) : ofColor(0,0,0);
+}
@@ -0,0 +1,126 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxTLMappedFile.h"
+
+//A timeline baked by ofxTLBaker: every value, switch and color track sampled ahead of time at a fixed rate.
+//Reading a value is an index into the file, with no keyframes to search or interpolate.
+//
+//Baked file layout, version 1, little endian like the track format:
+//	char[4]		magic "oftb"
+//	uint32		format version
+//	float32		samples per second
+//	uint64		time of the first sample in millis
+//	uint32		number of samples in each column
+//	uint32		number of columns
+//	per column:	string track name, string track type, uint32 column type, uint64 offset from the start of the file
+//	padding		zeros up to a multiple of 8 bytes
+//	the columns, each padded to a multiple of 8 bytes:
+//		values		float32[n]
+//		switches	uint8[(n+7)/8], sample i is bit i%8 of byte i/8
+//		colors		uint8[4n] rgba
+
+#define OFXTL_BAKED_MAGIC "oftb"
+#define OFXTL_BAKED_VERSION 1
+
+class ofxTLBakedTimeline {
+  public:
+	enum ColumnType {
+		VALUES,
+		SWITCHES,
+		COLORS
+	};
+	
+	ofxTLBakedTimeline();
+	
+	//maps the file and reads the columns in place, path is relative to the data folder
+	//only little endian machines can read baked files, which covers everything openFrameworks runs on
+	bool load(string path);
+	void close();
+	bool isLoaded() const;
+	
+	float getSampleRate() const;
+	unsigned long long getStartMillis() const;
+	unsigned long long getDurationInMilliseconds() const;
+	int getNumSamples() const;
+	
+	int getNumTracks() const;
+	bool hasTrack(const string& name) const;
+	//-1 if there's no such track. look indices up once and read by index each frame
+	int getTrackIndex(const string& name) const;
+	string getTrackName(int trackIndex) const;
+	string getTrackType(int trackIndex) const;
+	ColumnType getColumnType(int trackIndex) const;
+	
+	//the sample nearest a time, clamped to the baked range
+	int getSampleForMillis(double millis) const;
+	
+	float getValue(int trackIndex, int sample) const;
+	bool isSwitchOn(int trackIndex, int sample) const;
+	ofColor getColor(int trackIndex, int sample) const;
+	//the whole column, straight out of the mapped file
+	const float* getValues(int trackIndex) const;
+	const unsigned char* getSwitchBits(int trackIndex) const;
+	const unsigned char* getColors(int trackIndex) const;
+	
+	//stands in for ofxTimeline's queries, reading at the time set here
+	void setCurrentTimeMillis(unsigned long long millis);
+	void setCurrentTimeSeconds(float seconds);
+	float getValue(const string& name);
+	bool isSwitchOn(const string& name);
+	ofColor getColor(const string& name);
+	//and ofxTimeline's queries at other times
+	float getValue(const string& name, float atTime);
+	bool isSwitchOn(const string& name, float atTime);
+	ofColor getColorAtMillis(const string& name, unsigned long long millis);
+	
+  protected:
+	typedef struct {
+		string name;
+		string type;
+		ColumnType columnType;
+		const char* data;
+	} Column;
+	
+	ofxTLMappedFile file;
+	float sampleRate;
+	unsigned long long startMillis;
+	int numSamples;
+	vector<Column> columns;
+	map<string, int> trackIndices;
+	int currentSample;
+	
+	int findColumn(const string& name, ColumnType columnType) const;
+};
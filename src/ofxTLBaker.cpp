@@ -0,0 +1,185 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "ofxTLBaker.h"
+#include "ofxTimeline.h"
+#include "ofxTLBinaryFormat.h"
+
+ofxTLBaker::ofxTLBaker()
+:	nextColumn(0),
+	sampleRate(0),
+	startMillis(0),
+	numSamples(0)
+{
+	//
+}
+
+bool ofxTLBaker::bake(ofxTimeline& timeline, string path, float rate, int numThreads){
+	return bake(timeline, path, rate, timeline.getInTimeInMillis(), timeline.getOutTimeInMillis(), numThreads);
+}
+
+bool ofxTLBaker::bake(ofxTimeline& timeline, string path, float rate, unsigned long long start, unsigned long long end, int numThreads){
+	if(rate <= 0 || end < start){
+		ofLogError("ofxTLBaker::bake") << "nothing to bake at " << rate << " samples per second from " << start << " to " << end;
+		return false;
+	}
+	sampleRate = rate;
+	startMillis = start;
+	numSamples = (end - start) * sampleRate / 1000.0 + 1;
+	
+	columns.clear();
+	vector<ofxTLPage*>& pages = timeline.getPages();
+	for(int p = 0; p < pages.size(); p++){
+		vector<ofxTLTrack*>& tracks = pages[p]->getTracks();
+		for(int t = 0; t < tracks.size(); t++){
+			Column column;
+			column.track = tracks[t];
+			switch(ofxTLSnapshotLayout::getTrackKind(tracks[t])){
+				case ofxTLSnapshotLayout::VALUE:
+					column.columnType = ofxTLBakedTimeline::VALUES;
+					break;
+				case ofxTLSnapshotLayout::SWITCH:
+					column.columnType = ofxTLBakedTimeline::SWITCHES;
+					break;
+				case ofxTLSnapshotLayout::COLOR:
+					column.columnType = ofxTLBakedTimeline::COLORS;
+					//the workers can only read it
+					static_cast<ofxTLColorTrack*>(tracks[t])->refreshColorTable();
+					break;
+				default:
+					continue;
+			}
+			columns.push_back(column);
+		}
+	}
+	
+	nextColumn = 0;
+	vector<Worker*> workers;
+	numThreads = MAX(1, MIN(numThreads, (int)columns.size()));
+	for(int i = 0; i < numThreads; i++){
+		Worker* worker = new Worker();
+		worker->baker = this;
+		workers.push_back(worker);
+		worker->startThread(false, false);
+	}
+	for(int i = 0; i < workers.size(); i++){
+		workers[i]->waitForThread(false);
+		delete workers[i];
+	}
+	
+	//the header is the same size whatever the offsets are, so measure it first to know where the columns go
+	ofxTLBinaryWriter header;
+	for(int pass = 0; pass < 2; pass++){
+		unsigned long long columnOffset = header.getData().size();
+		header = ofxTLBinaryWriter();
+		header.writeBytes(OFXTL_BAKED_MAGIC, 4);
+		header.writeUInt32(OFXTL_BAKED_VERSION);
+		header.writeFloat(sampleRate);
+		header.writeUInt64(startMillis);
+		header.writeUInt32(numSamples);
+		header.writeUInt32(columns.size());
+		for(int i = 0; i < columns.size(); i++){
+			header.writeString(columns[i].track->getName());
+			header.writeString(columns[i].track->getTrackType());
+			header.writeUInt32(columns[i].columnType);
+			header.writeUInt64(columnOffset);
+			columnOffset += columns[i].data.size();
+		}
+		header.writePadding(8);
+	}
+	
+	ofstream file(ofToDataPath(path).c_str(), ios::out | ios::binary | ios::trunc);
+	file.write(header.getData().c_str(), header.getData().size());
+	for(int i = 0; i < columns.size(); i++){
+		file.write(columns[i].data.c_str(), columns[i].data.size());
+		//the file has them all now
+		string().swap(columns[i].data);
+	}
+	file.close();
+	if(file.fail()){
+		ofLogError("ofxTLBaker::bake") << "couldn't write " << path;
+		return false;
+	}
+	return true;
+}
+
+ofxTLBaker::Column* ofxTLBaker::takeNextColumn(){
+	Column* column = NULL;
+	queueLock.lock();
+	if(nextColumn < columns.size()){
+		column = &columns[nextColumn++];
+	}
+	queueLock.unlock();
+	return column;
+}
+
+void ofxTLBaker::sampleColumn(Column& column){
+	ofxTLBinaryWriter writer;
+	double sampleStep = 1000.0 / sampleRate;
+	if(column.columnType == ofxTLBakedTimeline::VALUES){
+		vector<float> values(numSamples);
+		static_cast<ofxTLKeyframes*>(column.track)->getValuesAtRate(startMillis, sampleRate, numSamples, &values[0]);
+		for(int i = 0; i < numSamples; i++){
+			writer.writeFloat(values[i]);
+		}
+	}
+	else if(column.columnType == ofxTLBakedTimeline::SWITCHES){
+		ofxTLSwitches* switches = static_cast<ofxTLSwitches*>(column.track);
+		vector<unsigned char> bits((numSamples+7)/8, 0);
+		for(int i = 0; i < numSamples; i++){
+			if(switches->isOnAtMillis(startMillis + sampleStep*i + .5)){
+				bits[i >> 3] |= 1 << (i & 7);
+			}
+		}
+		writer.writeBytes(&bits[0], bits.size());
+	}
+	else{
+		ofxTLColorTrack* colors = static_cast<ofxTLColorTrack*>(column.track);
+		ofxTLKeyframeCursor cursor;
+		for(int i = 0; i < numSamples; i++){
+			ofColor color = colors->getColorAtMillis(startMillis + sampleStep*i + .5, &cursor);
+			writer.writeUInt8(color.r);
+			writer.writeUInt8(color.g);
+			writer.writeUInt8(color.b);
+			writer.writeUInt8(color.a);
+		}
+	}
+	writer.writePadding(8);
+	column.data.swap(writer.getData());
+}
+
+void ofxTLBaker::Worker::threadedFunction(){
+	Column* column;
+	while((column = baker->takeNextColumn()) != NULL){
+		baker->sampleColumn(*column);
+	}
+}
@@ -0,0 +1,78 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxTLBakedTimeline.h"
+
+class ofxTimeline;
+class ofxTLTrack;
+
+//Samples every value, switch and color track of a timeline at a fixed rate into a baked file,
+//see ofxTLBakedTimeline for the layout and for reading it back.
+//Bangs, flags, cameras and media tracks have nothing to sample and are left out.
+//Tracks are sampled on several threads at once through the thread safe sampling functions,
+//so keys mustn't be edited until bake() returns.
+class ofxTLBaker {
+  public:
+	ofxTLBaker();
+	
+	//bakes the in/out range
+	bool bake(ofxTimeline& timeline, string path, float sampleRate, int numThreads = 4);
+	bool bake(ofxTimeline& timeline, string path, float sampleRate, unsigned long long startMillis, unsigned long long endMillis, int numThreads = 4);
+	
+  protected:
+	typedef struct {
+		ofxTLTrack* track;
+		ofxTLBakedTimeline::ColumnType columnType;
+		string data;
+	} Column;
+	
+	class Worker : public ofThread {
+	  public:
+		ofxTLBaker* baker;
+		void threadedFunction();
+	};
+	friend class Worker;
+	
+	//NULL once every column is taken
+	Column* takeNextColumn();
+	void sampleColumn(Column& column);
+	
+	vector<Column> columns;
+	int nextColumn;
+	ofMutex queueLock;
+	float sampleRate;
+	unsigned long long startMillis;
+	int numSamples;
+};
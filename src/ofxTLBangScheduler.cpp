@@ -0,0 +1,157 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "ofxTLBangScheduler.h"
+#include "ofxTimeline.h"
+#include "ofxTLClock.h"
+
+#ifdef TARGET_WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+//longest the thread sleeps before looking for newly queued bangs while others are waiting
+#define OFXTL_SCHEDULER_POLL_NANOS 1000000
+
+ofxTLBangScheduler::ofxTLBangScheduler()
+:	timeline(NULL)
+{
+	
+}
+
+ofxTLBangScheduler::~ofxTLBangScheduler(){
+	stop();
+}
+
+void ofxTLBangScheduler::start(ofxTimeline* newTimeline){
+	timeline = newTimeline;
+	if(!isThreadRunning()){
+		startThread(true, false);
+	}
+}
+
+void ofxTLBangScheduler::stop(){
+	if(isThreadRunning()){
+		stopThread();
+		queueLock.lock();
+		queued.signal();
+		queueLock.unlock();
+		waitForThread(false);
+	}
+	queueLock.lock();
+	queue.clear();
+	queueLock.unlock();
+}
+
+bool ofxTLBangScheduler::isRunning(){
+	return isThreadRunning();
+}
+
+void ofxTLBangScheduler::schedule(const ofxTLBangEventArgs& args, unsigned long long deadlineNanos){
+	queueLock.lock();
+	queue.insert(make_pair(deadlineNanos, args));
+	queued.signal();
+	queueLock.unlock();
+}
+
+void ofxTLBangScheduler::cancel(ofxTLTrack* track){
+	dispatchLock.lock();
+	//only a listener on the scheduler thread can get here with bangs still due
+	for(int i = 0; i < dueBangs.size(); i++){
+		if(dueBangs[i].second.track == track){
+			dueBangs[i].second.track = NULL;
+		}
+	}
+	queueLock.lock();
+	multimap<unsigned long long, ofxTLBangEventArgs>::iterator it = queue.begin();
+	while(it != queue.end()){
+		if(it->second.track == track){
+			queue.erase(it++);
+		}
+		else{
+			it++;
+		}
+	}
+	queueLock.unlock();
+	dispatchLock.unlock();
+}
+
+void ofxTLBangScheduler::threadedFunction(){
+	
+#ifdef TARGET_WIN32
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#else
+	sched_param param;
+	param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+	if(pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0){
+		ofLogNotice("ofxTLBangScheduler") << "couldn't give the bang thread real time priority, running it at normal priority";
+	}
+#endif
+	
+	while(isThreadRunning()){
+		queueLock.lock();
+		while(queue.empty() && isThreadRunning()){
+			queued.wait(queueLock);
+		}
+		unsigned long long wakeAt = ofxTLClock::getNanos() + OFXTL_SCHEDULER_POLL_NANOS;
+		if(!queue.empty()){
+			wakeAt = MIN(wakeAt, queue.begin()->first);
+		}
+		queueLock.unlock();
+		
+		ofxTLClock::sleepUntil(wakeAt);
+		
+		dispatchLock.lock();
+		unsigned long long now = ofxTLClock::getNanos();
+		queueLock.lock();
+		while(!queue.empty() && queue.begin()->first <= now){
+			dueBangs.push_back(*queue.begin());
+			queue.erase(queue.begin());
+		}
+		queueLock.unlock();
+		
+		//send outside of the queue lock so listeners can't hold up scheduling
+		for(int i = 0; i < dueBangs.size(); i++){
+			ofxTLBangEventArgs& args = dueBangs[i].second;
+			if(args.track == NULL){
+				continue;
+			}
+			args.latenessMillis = (ofxTLClock::getNanos() - dueBangs[i].first) / 1000000.0;
+			args.currentMillis = args.scheduledMillis + args.latenessMillis;
+			timeline->sendBangEvent(args);
+		}
+		dueBangs.clear();
+		dispatchLock.unlock();
+	}
+}
@@ -0,0 +1,72 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxTLEvents.h"
+#include "Poco/Condition.h"
+#include "Poco/Mutex.h"
+
+class ofxTimeline;
+class ofxTLTrack;
+
+//Sends bangs from a high priority thread at the moment they're due.
+//Bang tracks queue their upcoming keys with the clock time they fall on, see ofxTimeline::setPreciseBangs()
+class ofxTLBangScheduler : public ofThread {
+  public:
+	ofxTLBangScheduler();
+	virtual ~ofxTLBangScheduler();
+	
+	void start(ofxTimeline* timeline);
+	void stop();
+	bool isRunning();
+	
+	//args is sent when ofxTLClock::getNanos() reaches deadlineNanos, with its lateness filled in
+	void schedule(const ofxTLBangEventArgs& args, unsigned long long deadlineNanos);
+	//forgets the track's bangs that haven't been sent yet, for stops and jumps back
+	//waits for a batch that is being sent, so a track may be deleted once this returns
+	void cancel(ofxTLTrack* track);
+	
+  protected:
+	virtual void threadedFunction();
+	
+	ofxTimeline* timeline;
+	ofMutex queueLock;
+	//signalled when a bang is queued or the thread is stopped, the thread waits on it while the queue is empty
+	Poco::Condition queued;
+	multimap<unsigned long long, ofxTLBangEventArgs> queue;
+	
+	//held while bangs are taken off the queue and sent. recursive so listeners can cancel from inside a bang
+	Poco::Mutex dispatchLock;
+	vector< pair<unsigned long long, ofxTLBangEventArgs> > dueBangs;
+};
@@ -36,10 +36,17 @@
 ofxTLBangs::ofxTLBangs(){
     lastTimelinePoint = 0;
 	lastBangTime = 0;
+	bangsScheduled = false;
+	scheduledUntil = 0;
+	bangCursor = 0;
+	includeLastPoint = true;
 }
 
 ofxTLBangs::~ofxTLBangs(){
 	disable();
+	if(timeline != NULL){
+		timeline->getBangScheduler().cancel(this);
+	}
 }
 
 void ofxTLBangs::draw(){
@@ -107,23 +114,86 @@ ofxTLKeyframe* ofxTLBangs::keyframeAtScreenpoint(ofVec2f p){
 void ofxTLBangs::update(){
 //	if(isPlaying || timeline->getIsPlaying()){
 		long thisTimelinePoint = currentTrackTime();
-		for(int i = 0; i < keyframes.size(); i++){
-			if(timeline->getInOutRangeMillis().contains(keyframes[i]->time) &&
-               lastTimelinePoint <= keyframes[i]->time &&
-               thisTimelinePoint >= keyframes[i]->time &&
-               thisTimelinePoint != lastTimelinePoint)
-            {
+		//only the timeline's own playback runs on its clock, solo track playback sends bangs as it goes
+		if(timeline->getPreciseBangs() && timeline->getIsPlaying() && !isPlaying){
+			scheduleBangs(thisTimelinePoint);
+			lastTimelinePoint = thisTimelinePoint;
+			return;
+		}
+		bangsScheduled = false;
+		if(thisTimelinePoint > lastTimelinePoint){
+			//fire the keys crossed since the last update that are inside the in/out range
+			ofLongRange inOut = timeline->getInOutRangeMillis();
+			unsigned long long crossedEnd = MIN((unsigned long long)thisTimelinePoint, inOut.max);
+			//a key right on the last point was sent by the last update, unless playback has just started there
+			unsigned long long crossedStart = includeLastPoint ? lastTimelinePoint : lastTimelinePoint+1;
+			int i = firstKeyAtOrAfter(MAX(crossedStart, inOut.min));
+			for(; i < keyTimes.size() && keyTimes[i] <= crossedEnd; i++){
 //				ofLogNotice() << "fired bang with accuracy of " << (keyframes[i]->time - thisTimelinePoint) << endl;
 				bangFired(keyframes[i]);
 				lastBangTime = ofGetElapsedTimef();
 			}
+			bangCursor = i;
+			includeLastPoint = false;
+		}
+		else if(thisTimelinePoint < lastTimelinePoint){
+			includeLastPoint = true;
 		}
 		lastTimelinePoint = thisTimelinePoint;
 //	}
 }
 
+void ofxTLBangs::scheduleBangs(long thisTimelinePoint){
+	//start from where the old way of sending would have, or over again after a jump back
+	if(!bangsScheduled || thisTimelinePoint < lastTimelinePoint){
+		timeline->getBangScheduler().cancel(this);
+		scheduledUntil = MIN(lastTimelinePoint, thisTimelinePoint);
+		bangsScheduled = true;
+	}
+	
+	ofLongRange inOut = timeline->getInOutRangeMillis();
+	unsigned long long horizon = MIN(thisTimelinePoint + timeline->getBangLookaheadMillis(), inOut.max);
+	if(horizon < scheduledUntil){
+		return;
+	}
+	
+	double preciseMillis = timeline->getPreciseTimeMillis();
+	unsigned long long nowNanos = ofxTLClock::getNanos();
+	int i = firstKeyAtOrAfter(MAX(scheduledUntil, inOut.min));
+	for(; i < keyTimes.size() && keyTimes[i] <= horizon; i++){
+		ofxTLBangEventArgs args;
+		createBangEvent(keyframes[i], args);
+		//keys the playhead already passed are due in the past and go out immediately, reporting how late they are
+		unsigned long long deadlineNanos = nowNanos + (keyTimes[i] - preciseMillis)*1000000.0;
+		timeline->getBangScheduler().schedule(args, deadlineNanos);
+		lastBangTime = ofGetElapsedTimef();
+	}
+	bangCursor = i;
+	scheduledUntil = horizon+1;
+}
+
+int ofxTLBangs::firstKeyAtOrAfter(unsigned long long millis){
+	if(!hasKeyColumns()){
+		updateKeyframeColumns();
+	}
+	//during playback this is where the last update stopped, so only search after loops, jumps and edits
+	if(bangCursor >= 0 && bangCursor <= keyTimes.size() &&
+	   (bangCursor == 0 || keyTimes[bangCursor-1] < millis) &&
+	   (bangCursor == keyTimes.size() || keyTimes[bangCursor] >= millis))
+	{
+		return bangCursor;
+	}
+	bangCursor = lower_bound(keyTimes.begin(), keyTimes.end(), millis) - keyTimes.begin();
+	return bangCursor;
+}
+
 void ofxTLBangs::bangFired(ofxTLKeyframe* key){
     ofxTLBangEventArgs args;
+	createBangEvent(key, args);
+	timeline->sendBangEvent(args);
+}
+
+void ofxTLBangs::createBangEvent(ofxTLKeyframe* key, ofxTLBangEventArgs& args){
     args.sender = timeline;
     args.track = this;
 	//play solo change
@@ -132,20 +202,32 @@ void ofxTLBangs::bangFired(ofxTLKeyframe* key){
     args.currentPercent = timeline->getPercentComplete();
     args.currentFrame = timeline->getCurrentFrame();
     args.currentTime = timeline->getCurrentTime();
-    ofNotifyEvent(events().bangFired, args);    
+	args.scheduledMillis = key->time;
+	args.latenessMillis = MAX(0, (isPlaying ? currentTrackTime() : timeline->getPreciseTimeMillis()) - key->time);
 }
 
 void ofxTLBangs::playbackStarted(ofxTLPlaybackEventArgs& args){
 	ofxTLTrack::playbackStarted(args);
 	lastTimelinePoint = currentTrackTime();
+	includeLastPoint = true;
+}
+
+void ofxTLBangs::playheadJumped(){
+	lastTimelinePoint = currentTrackTime();
+	includeLastPoint = true;
 }
 
 void ofxTLBangs::playbackEnded(ofxTLPlaybackEventArgs& args){
 //    isPlayingBack = false;
+	timeline->getBangScheduler().cancel(this);
+	bangsScheduled = false;
 }
 
 void ofxTLBangs::playbackLooped(ofxTLPlaybackEventArgs& args){
 	lastTimelinePoint = 0;
+	includeLastPoint = true;
+	//the keys before the loop point are already queued
+	scheduledUntil = 0;
 }
 
 string ofxTLBangs::getTrackType(){
@@ -47,11 +47,17 @@ class ofxTLBangs : public ofxTLKeyframes {
 	virtual void playbackStarted(ofxTLPlaybackEventArgs& args);
 	virtual void playbackEnded(ofxTLPlaybackEventArgs& args);
 	virtual void playbackLooped(ofxTLPlaybackEventArgs& args);
+	virtual void playheadJumped();
     
     virtual string getTrackType();
+	//bang keys are plain keyframes, so they can load on a worker thread
+	virtual bool canLoadOnThread(){ return true; }
     
  protected:
 
+	//bangs are fired from the keyframe objects
+	virtual bool canSampleMappedKeys() const { return false; }
+
     virtual ofxTLKeyframe* keyframeAtScreenpoint(ofVec2f p);
 //    bool isPlayingBack;
 	virtual void update();
@@ -59,5 +65,19 @@ class ofxTLBangs : public ofxTLKeyframes {
     long lastTimelinePoint;
 	float lastBangTime; //just for display
 	
+	//sends the key's event right away
     virtual void bangFired(ofxTLKeyframe* key);
+	//fills in the event for a key, override to add to it like ofxTLFlags does
+	virtual void createBangEvent(ofxTLKeyframe* key, ofxTLBangEventArgs& args);
+	
+	//index of the first key at or after millis, searching only when the key after the last bang doesn't fit
+	int firstKeyAtOrAfter(unsigned long long millis);
+	int bangCursor;
+	bool includeLastPoint; //set when playback starts or jumps, so a key right on lastTimelinePoint is sent
+	
+	//precise bangs, see ofxTimeline::setPreciseBangs()
+	//queues the keys from scheduledUntil up to the lookahead past thisTimelinePoint with the scheduler
+	void scheduleBangs(long thisTimelinePoint);
+	bool bangsScheduled;
+	unsigned long long scheduledUntil; //keys before this have been queued
 };
\ No newline at end of file
@@ -0,0 +1,210 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "ofxTLBinaryFormat.h"
+
+bool ofxTLBinaryHostIsLittleEndian(){
+	unsigned int test = 1;
+	return *(unsigned char*)&test == 1;
+}
+
+//copies length bytes reversing their order on big endian machines
+static void copyLittleEndian(void* dest, const void* src, size_t length){
+	if(ofxTLBinaryHostIsLittleEndian()){
+		memcpy(dest, src, length);
+	}
+	else{
+		for(size_t i = 0; i < length; i++){
+			((unsigned char*)dest)[i] = ((const unsigned char*)src)[length-1-i];
+		}
+	}
+}
+
+void ofxTLBinaryWriter::writeBytes(const void* bytes, size_t length){
+	data.append((const char*)bytes, length);
+}
+
+void ofxTLBinaryWriter::writeUInt8(unsigned char value){
+	data.push_back((char)value);
+}
+
+void ofxTLBinaryWriter::writeUInt32(unsigned int value){
+	char bytes[4];
+	copyLittleEndian(bytes, &value, 4);
+	writeBytes(bytes, 4);
+}
+
+void ofxTLBinaryWriter::writeUInt64(unsigned long long value){
+	char bytes[8];
+	copyLittleEndian(bytes, &value, 8);
+	writeBytes(bytes, 8);
+}
+
+void ofxTLBinaryWriter::writeFloat(float value){
+	char bytes[4];
+	copyLittleEndian(bytes, &value, 4);
+	writeBytes(bytes, 4);
+}
+
+void ofxTLBinaryWriter::writeString(const string& value){
+	writeUInt32(value.size());
+	writeBytes(value.c_str(), value.size());
+}
+
+void ofxTLBinaryWriter::writePadding(size_t alignment){
+	while(data.size() % alignment != 0){
+		data.push_back(0);
+	}
+}
+
+void ofxTLBinaryWriter::beginBlock(){
+	blockStarts.push_back(data.size());
+	writeUInt32(0);
+}
+
+void ofxTLBinaryWriter::endBlock(){
+	if(blockStarts.empty()){
+		ofLogError("ofxTLBinaryWriter::endBlock") << "no block to end";
+		return;
+	}
+	size_t blockStart = blockStarts.back();
+	blockStarts.pop_back();
+	unsigned int blockLength = data.size() - blockStart - 4;
+	copyLittleEndian(&data[blockStart], &blockLength, 4);
+}
+
+string& ofxTLBinaryWriter::getData(){
+	return data;
+}
+
+ofxTLBinaryReader::ofxTLBinaryReader(const char* data, size_t length)
+:	data(data),
+	length(length),
+	position(0),
+	failed(false)
+{
+	//
+}
+
+bool ofxTLBinaryReader::readBytes(void* bytes, size_t numBytes){
+	if(failed || numBytes > length - position){
+		failed = true;
+		memset(bytes, 0, numBytes);
+		return false;
+	}
+	memcpy(bytes, data + position, numBytes);
+	position += numBytes;
+	return true;
+}
+
+unsigned char ofxTLBinaryReader::readUInt8(){
+	unsigned char value;
+	readBytes(&value, 1);
+	return value;
+}
+
+unsigned int ofxTLBinaryReader::readUInt32(){
+	char bytes[4];
+	unsigned int value;
+	readBytes(bytes, 4);
+	copyLittleEndian(&value, bytes, 4);
+	return value;
+}
+
+unsigned long long ofxTLBinaryReader::readUInt64(){
+	char bytes[8];
+	unsigned long long value;
+	readBytes(bytes, 8);
+	copyLittleEndian(&value, bytes, 8);
+	return value;
+}
+
+float ofxTLBinaryReader::readFloat(){
+	char bytes[4];
+	float value;
+	readBytes(bytes, 4);
+	copyLittleEndian(&value, bytes, 4);
+	return value;
+}
+
+string ofxTLBinaryReader::readString(){
+	unsigned int stringLength = readUInt32();
+	if(failed || stringLength > length - position){
+		failed = true;
+		return "";
+	}
+	string value(data + position, stringLength);
+	position += stringLength;
+	return value;
+}
+
+bool ofxTLBinaryReader::skipBytes(size_t numBytes){
+	if(failed || numBytes > length - position){
+		failed = true;
+		return false;
+	}
+	position += numBytes;
+	return true;
+}
+
+//padding is relative to the start of the data, so only use this on readers over a whole file
+bool ofxTLBinaryReader::skipPadding(size_t alignment){
+	return skipBytes((alignment - position % alignment) % alignment);
+}
+
+ofxTLBinaryReader ofxTLBinaryReader::readBlock(){
+	unsigned int blockLength = readUInt32();
+	if(failed || blockLength > length - position){
+		failed = true;
+		return ofxTLBinaryReader(NULL, 0);
+	}
+	ofxTLBinaryReader block(data + position, blockLength);
+	position += blockLength;
+	return block;
+}
+
+bool ofxTLBinaryReader::good(){
+	return !failed;
+}
+
+bool ofxTLBinaryReader::atEnd(){
+	return position == length;
+}
+
+size_t ofxTLBinaryReader::getPosition(){
+	return position;
+}
+
+size_t ofxTLBinaryReader::getRemaining(){
+	return length - position;
+}
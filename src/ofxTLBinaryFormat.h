@@ -0,0 +1,112 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#pragma once
+
+#include "ofMain.h"
+
+//Helpers for the binary track format. Everything is written little endian
+//regardless of the machine so files move between platforms.
+//
+//Track file layout, version 2:
+//	char[4]		magic "oftl"
+//	uint32		format version
+//	string		track type, as returned by getTrackType()
+//	uint32		number of keys
+//	padding		zeros up to a multiple of 8 bytes from the start of the file
+//	uint64[n]	key times in millis
+//	float32[n]	normalized key values
+//	padding		zeros up to a multiple of 8 bytes
+//	uint64[n]	offset of each key's payload from the start of the file
+//	per key:	uint32 payload length, then the payload written by the track's storeKeyframeBinary
+//
+//the padding lets the columns be used in place when the file is memory mapped, see ofxTLMappedFile
+//version 1 files have no padding or offsets
+//strings are a uint32 byte length followed by the bytes
+
+#define OFXTL_BINARY_MAGIC "oftl"
+#define OFXTL_BINARY_VERSION 2
+
+//when this is false the columns have to be byte swapped and can't be used in place
+bool ofxTLBinaryHostIsLittleEndian();
+
+class ofxTLBinaryWriter {
+  public:
+	void writeBytes(const void* bytes, size_t length);
+	void writeUInt8(unsigned char value);
+	void writeUInt32(unsigned int value);
+	void writeUInt64(unsigned long long value);
+	void writeFloat(float value);
+	void writeString(const string& value);
+	//zeros up to the next multiple of alignment bytes
+	void writePadding(size_t alignment);
+	
+	//writes a length prefix now and fills it in with the size of everything written before endBlock
+	void beginBlock();
+	void endBlock();
+	
+	string& getData();
+	
+  protected:
+	string data;
+	vector<size_t> blockStarts;
+};
+
+class ofxTLBinaryReader {
+  public:
+	ofxTLBinaryReader(const char* data, size_t length);
+	
+	//reads past the end fail quietly and return zero, check good() afterwards
+	bool readBytes(void* bytes, size_t length);
+	unsigned char readUInt8();
+	unsigned int readUInt32();
+	unsigned long long readUInt64();
+	float readFloat();
+	string readString();
+	bool skipBytes(size_t numBytes);
+	bool skipPadding(size_t alignment);
+	
+	//reads a length prefixed block into its own reader and skips over it
+	ofxTLBinaryReader readBlock();
+	
+	bool good();
+	bool atEnd();
+	size_t getPosition();
+	size_t getRemaining();
+
+  protected:
+	const char* data;
+	size_t length;
+	size_t position;
+	bool failed;
+};
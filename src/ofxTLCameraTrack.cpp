@@ -53,6 +53,7 @@ ofVec3f ofHermiteInterpolate(ofVec3f y0, ofVec3f y1, ofVec3f y2, ofVec3f y3, flo
 
 ofxTLCameraTrack::ofxTLCameraTrack(){
 	camera = NULL;
+	cameraSegmentsValid = false;
 	lockCameraToTrack = false;
 	dampening = .1;
 }
@@ -318,6 +319,7 @@ void ofxTLCameraTrack::keyPressed(ofKeyEventArgs& args){
 	}
 	
 	if(modified){
+		cameraSegmentsValid = false;
 		timeline->flagTrackModified(this);
 	}
 	
@@ -337,7 +339,7 @@ string ofxTLCameraTrack::getTrackType(){
 
 ofxTLKeyframe* ofxTLCameraTrack::newKeyframe(){
 	//return our type of keyframe, stored in the parent class
-	ofxTLCameraFrame* newKey = new ofxTLCameraFrame();
+	ofxTLCameraFrame* newKey = createKeyframe<ofxTLCameraFrame>();
 	if(camera != NULL){
 		newKey->position = camera->getPosition();
 		newKey->orientation = camera->getOrientationQuat();
@@ -358,6 +360,21 @@ void ofxTLCameraTrack::restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlSt
 								  xmlStore.getValue("ow", 1.));
 	cameraFrame->easeIn  = (CameraTrackEase)xmlStore.getValue("easein", (int)OFXTL_CAMERA_EASE_LINEAR);
 	cameraFrame->easeOut = (CameraTrackEase)xmlStore.getValue("easeout", (int)OFXTL_CAMERA_EASE_LINEAR);
+	cameraSegmentsValid = false;
+}
+
+void ofxTLCameraTrack::restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues){
+	ofxTLCameraFrame* cameraFrame = (ofxTLCameraFrame*)key;
+	cameraFrame->position = ofVec3f(keyValues.getValue("px", 0.),
+									keyValues.getValue("py", 0.),
+									keyValues.getValue("pz", 0.));
+	cameraFrame->orientation.set(keyValues.getValue("ox", 0.),
+								  keyValues.getValue("oy", 0.),
+								  keyValues.getValue("oz", 0.),
+								  keyValues.getValue("ow", 1.));
+	cameraFrame->easeIn  = (CameraTrackEase)keyValues.getValue("easein", (int)OFXTL_CAMERA_EASE_LINEAR);
+	cameraFrame->easeOut = (CameraTrackEase)keyValues.getValue("easeout", (int)OFXTL_CAMERA_EASE_LINEAR);
+	cameraSegmentsValid = false;
 }
 
 void ofxTLCameraTrack::storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore){
@@ -375,6 +392,36 @@ void ofxTLCameraTrack::storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStor
 	xmlStore.addValue("easeout", (int)cameraFrame->easeOut);
 }
 
+void ofxTLCameraTrack::restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader){
+	ofxTLCameraFrame* cameraFrame = (ofxTLCameraFrame*)key;
+	cameraFrame->position.x = reader.readFloat();
+	cameraFrame->position.y = reader.readFloat();
+	cameraFrame->position.z = reader.readFloat();
+	float ox = reader.readFloat();
+	float oy = reader.readFloat();
+	float oz = reader.readFloat();
+	float ow = reader.readFloat();
+	cameraFrame->orientation.set(ox, oy, oz, ow);
+	cameraFrame->easeIn  = (CameraTrackEase)reader.readUInt8();
+	cameraFrame->easeOut = (CameraTrackEase)reader.readUInt8();
+	cameraSegmentsValid = false;
+}
+
+void ofxTLCameraTrack::storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer){
+	ofxTLCameraFrame* cameraFrame = (ofxTLCameraFrame*)key;
+	writer.writeFloat(cameraFrame->position.x);
+	writer.writeFloat(cameraFrame->position.y);
+	writer.writeFloat(cameraFrame->position.z);
+	
+	writer.writeFloat(cameraFrame->orientation._v.x);
+	writer.writeFloat(cameraFrame->orientation._v.y);
+	writer.writeFloat(cameraFrame->orientation._v.z);
+	writer.writeFloat(cameraFrame->orientation._v.w);
+	
+	writer.writeUInt8(cameraFrame->easeIn);
+	writer.writeUInt8(cameraFrame->easeOut);
+}
+
 ofxTLKeyframe* ofxTLCameraTrack::keyframeAtScreenpoint(ofVec2f p){
     if(bounds.inside(p.x, p.y)){
         for(int i = 0; i < keyframes.size(); i++){
@@ -424,17 +471,149 @@ void ofxTLCameraTrack::moveCameraToTime(unsigned long long millis){
 	//	cout << "set position to " << camera->getPosition() << endl;
 }
 
+//leaves the target alone at or past the last frame, and carries the first segment on back before the first
 void ofxTLCameraTrack::setCameraFrameToTime(ofxTLCameraFrame* target, unsigned long long millis){
-	for(int i = 1; i < keyframes.size(); i++){
-		if(keyframes[i]->time > millis){
-			ofxTLCameraFrame* prev = (ofxTLCameraFrame*)(i > 2 ? keyframes[i-2] : keyframes[i-1]);
-			ofxTLCameraFrame* next = (ofxTLCameraFrame*)(i < keyframes.size()-1 ? keyframes[i+1] : keyframes[i]);
-			interpolateBetween(target, prev, (ofxTLCameraFrame*)keyframes[i-1], (ofxTLCameraFrame*)keyframes[i], next, millis);
-			break;
+	refreshCameraSegments();
+	if(cameraSegments.empty()){
+		return;
+	}
+	int i = upper_bound(keyTimes.begin(), keyTimes.end(), millis) - keyTimes.begin();
+	if(i == keyTimes.size()){
+		return;
+	}
+	target->time = millis;
+	evaluateCameraSegment(cameraSegments[MAX(i, 1) - 1], millis, target->position, target->orientation);
+}
+
+void ofxTLCameraTrack::sampleCameraPath(unsigned long long startMillis, unsigned long long endMillis, double stepMillis,
+										vector<ofVec3f>& positions, vector<ofQuaternion>& orientations)
+{
+	positions.clear();
+	orientations.clear();
+	if(keyframes.empty() || stepMillis <= 0 || endMillis < startMillis){
+		return;
+	}
+	refreshCameraSegments();
+	
+	int count = (endMillis - startMillis) / stepMillis + 1;
+	positions.resize(count);
+	orientations.resize(count);
+	ofxTLCameraFrame* firstFrame = (ofxTLCameraFrame*)keyframes[0];
+	ofxTLCameraFrame* lastFrame = (ofxTLCameraFrame*)keyframes[keyframes.size()-1];
+	//the segments only move forward, so walk them instead of searching for each sample
+	int segment = 0;
+	for(int s = 0; s < count; s++){
+		double millis = startMillis + stepMillis*s;
+		//held at the ends like the camera is
+		if(cameraSegments.empty() || millis <= firstFrame->time){
+			positions[s] = firstFrame->position;
+			orientations[s] = firstFrame->orientation;
+		}
+		else if(millis >= lastFrame->time){
+			positions[s] = lastFrame->position;
+			orientations[s] = lastFrame->orientation;
+		}
+		else{
+			while(keyTimes[segment+1] <= millis){
+				segment++;
+			}
+			evaluateCameraSegment(cameraSegments[segment], millis, positions[s], orientations[s]);
 		}
 	}
 }
 
+void ofxTLCameraTrack::refreshCameraSegments(){
+	if(!cameraSegmentsValid || !hasKeyColumns() || cameraSegments.size() + 1 != keyframes.size()){
+		updateKeyframeColumns();
+	}
+}
+
+void ofxTLCameraTrack::updateKeyframeColumns(){
+	ofxTLKeyframes::updateKeyframeColumns();
+	
+	cameraSegments.resize(MAX((int)keyframes.size() - 1, 0));
+	for(int i = 0; i < cameraSegments.size(); i++){
+		updateCameraSegment(i);
+	}
+	cameraSegmentsValid = true;
+}
+
+//a new last frame is the next point of the segment before it, so that one changes too
+void ofxTLCameraTrack::keyframeAppended(ofxTLKeyframe* key){
+	ofxTLKeyframes::keyframeAppended(key);
+	if(!cameraSegmentsValid || cameraSegments.size() + 2 != keyframes.size()){
+		updateKeyframeColumns();
+		return;
+	}
+	cameraSegments.resize(keyframes.size() - 1);
+	for(int i = MAX((int)cameraSegments.size() - 2, 0); i < cameraSegments.size(); i++){
+		updateCameraSegment(i);
+	}
+}
+
+//hermite position and slerped orientation between two frames, with everything that only depends on the frames done once per segment
+void ofxTLCameraTrack::updateCameraSegment(int i){
+	int numKeys = keyframes.size();
+	ofxTLCameraFrame* sample1 = (ofxTLCameraFrame*)keyframes[i];
+	ofxTLCameraFrame* sample2 = (ofxTLCameraFrame*)keyframes[i+1];
+	//the neighbours setCameraFrameToTime has always used
+	ofxTLCameraFrame* prev = (ofxTLCameraFrame*)(i+1 > 2 ? keyframes[i-1] : keyframes[i]);
+	ofxTLCameraFrame* next = (ofxTLCameraFrame*)(i+1 < numKeys-1 ? keyframes[i+2] : keyframes[i+1]);
+	ofxTLCameraSegment& segment = cameraSegments[i];
+	
+	segment.startTime = sample1->time;
+	segment.inverseDuration = sample2->time > sample1->time ? 1.0 / (sample2->time - sample1->time) : 0;
+	segment.cut = sample1->easeOut == OFXTL_CAMERA_EASE_CUT || sample2->easeIn == OFXTL_CAMERA_EASE_CUT;
+	segment.ease = NULL;
+	if(sample1->easeOut == OFXTL_CAMERA_EASE_SMOOTH && sample2->easeIn == OFXTL_CAMERA_EASE_SMOOTH){
+		segment.ease = &ofxTLEaseSample<ofxTLEasingQuad, ofxTween::easeInOut>;
+	}
+	else if(sample1->easeOut == OFXTL_CAMERA_EASE_SMOOTH){
+		segment.ease = &ofxTLEaseSample<ofxTLEasingQuad, ofxTween::easeIn>;
+	}
+	else if(sample2->easeIn == OFXTL_CAMERA_EASE_SMOOTH){
+		segment.ease = &ofxTLEaseSample<ofxTLEasingQuad, ofxTween::easeOut>;
+	}
+	
+	//ofHermiteInterpolate with no tension or bias
+	ofVec3f y0 = prev->position, y1 = sample1->position, y2 = sample2->position, y3 = next->position;
+	ofVec3f m0 = (y2 - y0) * .5;
+	ofVec3f m1 = (y3 - y1) * .5;
+	segment.position[0] = y1;
+	segment.position[1] = m0;
+	segment.position[2] = y2*3 - y1*3 - m0*2 - m1;
+	segment.position[3] = y1*2 - y2*2 + m0 + m1;
+	
+	//ofQuaternion::slerp's setup
+	segment.orientationFrom = sample1->orientation.asVec4();
+	segment.orientationTo = sample2->orientation.asVec4();
+	double cosOmega = segment.orientationFrom.dot(segment.orientationTo);
+	if(cosOmega < 0){
+		cosOmega = -cosOmega;
+		segment.orientationTo = -segment.orientationTo;
+	}
+	segment.slerp = 1.0 - cosOmega > 0.00001;
+	segment.omega = segment.slerp ? acos(cosOmega) : 0;
+	segment.inverseSinOmega = segment.slerp ? 1.0 / sin(segment.omega) : 0;
+}
+
+void ofxTLCameraTrack::evaluateCameraSegment(const ofxTLCameraSegment& segment, double millis, ofVec3f& position, ofQuaternion& orientation) const{
+	float alpha = 0;
+	if(!segment.cut){
+		float x = (millis - segment.startTime) * segment.inverseDuration;
+		alpha = segment.ease == NULL ? x : segment.ease(x);
+	}
+	position = segment.position[0] + (segment.position[1] + (segment.position[2] + segment.position[3]*alpha)*alpha)*alpha;
+	
+	double scaleFrom = 1.0 - alpha;
+	double scaleTo = alpha;
+	if(segment.slerp){
+		scaleFrom = sin((1.0 - alpha) * segment.omega) * segment.inverseSinOmega;
+		scaleTo = sin(alpha * segment.omega) * segment.inverseSinOmega;
+	}
+	orientation.set(segment.orientationFrom*scaleFrom + segment.orientationTo*scaleTo);
+}
+
 void ofxTLCameraTrack::moveCameraToPosition(ofxTLCameraFrame* target){
 	camera->setPosition(camera->getPosition().getInterpolated(target->position, dampening) );
 	ofQuaternion q;
@@ -458,47 +637,6 @@ void ofxTLCameraTrack::jumpToTarget(){
     dampening = curDamp;
 }
 
-void ofxTLCameraTrack::interpolateBetween(ofxTLCameraFrame* target,
-										  ofxTLCameraFrame* prev,
-										  ofxTLCameraFrame* sample1,
-										  ofxTLCameraFrame* sample2,
-										  ofxTLCameraFrame* next, unsigned long long millis)
-{
-
-    float alpha = 0;
-    //CUT
-    if(sample1->easeOut == OFXTL_CAMERA_EASE_CUT || sample2->easeIn == OFXTL_CAMERA_EASE_CUT ){
-        alpha = 0;
-    }
-    //LINEAR
-    else if(sample1->easeOut == OFXTL_CAMERA_EASE_LINEAR && sample2->easeIn == OFXTL_CAMERA_EASE_LINEAR){
-        alpha = ofMap(millis, sample1->time, sample2->time, 0, 1.0, false);
-    }
-    //EASE IN
-    else if(sample1->easeOut == OFXTL_CAMERA_EASE_SMOOTH && sample2->easeIn == OFXTL_CAMERA_EASE_LINEAR){
-        ofxEasingQuad ease;
-        alpha = ofxTween::map(millis, sample1->time, sample2->time, 0, 1.0, false, ease, ofxTween::easeIn);
-    }
-    //EASE OUT
-    else if(sample1->easeOut == OFXTL_CAMERA_EASE_LINEAR && sample2->easeIn == OFXTL_CAMERA_EASE_SMOOTH){
-        ofxEasingQuad ease;
-        alpha = ofxTween::map(millis, sample1->time, sample2->time, 0, 1.0, false, ease, ofxTween::easeOut);
-    }
-    //EASE IN OUT
-    else if(sample1->easeOut == OFXTL_CAMERA_EASE_SMOOTH && sample2->easeIn == OFXTL_CAMERA_EASE_SMOOTH){
-        ofxEasingQuad ease;
-        alpha = ofxTween::map(millis, sample1->time, sample2->time, 0, 1.0, false, ease, ofxTween::easeInOut);
-    }
-    
-	//float alpha = ofMap(millis, sample1->time, sample2->time, 0, 1.0, false);
-    
-	target->time = millis;
-	target->position = ofHermiteInterpolate(prev->position,sample1->position,sample2->position,next->position,alpha,0,0);
-	//	interp.position = sample1.position.getInterpolated(sample2.position, alpha);
-	target->orientation.slerp(alpha, sample1->orientation, sample2->orientation);
-	//cout << "interpolating between " << sample1.position << " and " << sample2.position << " with alpha " << alpha << endl;
-}
-
 void ofxTLCameraTrack::selectedKeySecondaryClick(ofMouseEventArgs& args){
 	//you can make a popup window start here
 //	timeline->presentedModalContent(this);
@@ -34,6 +34,7 @@
 
 #include "ofMain.h"
 #include "ofxTLKeyframes.h"
+#include "ofxTLEasing.h"
 typedef enum {
     OFXTL_CAMERA_EASE_LINEAR,
     OFXTL_CAMERA_EASE_SMOOTH,
@@ -53,6 +54,22 @@ class ofxTLCameraFrame : public ofxTLKeyframe {
 	bool easeInSelected;
 };
 
+//the interpolation between two frames worked out ahead, see ofxTLCameraTrack::updateKeyframeColumns
+typedef struct {
+	unsigned long long startTime;
+	double inverseDuration;
+	bool cut;
+	ofxTLEaseFunction ease; //NULL when linear
+	//the hermite curve through the frames as a cubic in alpha, position[0] + position[1]*alpha + ...
+	ofVec3f position[4];
+	//the end orientations, the second flipped if needed so the slerp takes the short way round
+	ofVec4f orientationFrom;
+	ofVec4f orientationTo;
+	double omega;
+	double inverseSinOmega;
+	bool slerp; //false when the ends are close enough to blend linearly
+} ofxTLCameraSegment;
+
 //Just a simple useless random color keyframer
 //to show how to create a custom keyframer
 class ofxTLCameraTrack : public ofxTLKeyframes {
@@ -99,6 +116,12 @@ class ofxTLCameraTrack : public ofxTLKeyframes {
 
 	//return a custom name for this keyframe
 	virtual string getTrackType();
+	virtual bool supportsUndoDeltas(){ return false; }
+	
+	//fills positions and orientations with the camera path from startMillis to endMillis every stepMillis,
+	//both ends included, without moving the camera. for exporting paths to offline renders
+	void sampleCameraPath(unsigned long long startMillis, unsigned long long endMillis, double stepMillis,
+						  vector<ofVec3f>& positions, vector<ofQuaternion>& orientations);
 
   protected:
 	ofCamera* camera;
@@ -108,11 +131,15 @@ class ofxTLCameraTrack : public ofxTLKeyframes {
 
 	void moveCameraToTime(unsigned long long millis);
 	void setCameraFrameToTime(ofxTLCameraFrame* target, unsigned long long millis);
-	void interpolateBetween(ofxTLCameraFrame* target,
-							ofxTLCameraFrame* prev,
-							ofxTLCameraFrame* sample1,
-							ofxTLCameraFrame* sample2,
-							ofxTLCameraFrame* next, unsigned long long millis);
+	
+	//segment i runs from key i to key i+1, rebuilt with the key columns and lazily after the eases change
+	virtual void updateKeyframeColumns();
+	virtual void keyframeAppended(ofxTLKeyframe* key);
+	void updateCameraSegment(int i);
+	void refreshCameraSegments();
+	void evaluateCameraSegment(const ofxTLCameraSegment& segment, double millis, ofVec3f& position, ofQuaternion& orientation) const;
+	vector<ofxTLCameraSegment> cameraSegments;
+	bool cameraSegmentsValid;
 	float dampening;
 	void moveCameraToPosition(ofxTLCameraFrame* target);
 	
@@ -125,11 +152,16 @@ class ofxTLCameraTrack : public ofxTLKeyframes {
 	//always return the type for your track, in our case ofxTLEmptyKeyframe;
 	//this will enusre that all keyframe objects passed to this class are of this type
 	virtual ofxTLKeyframe* newKeyframe();
+	virtual bool canSampleMappedKeys() const { return false; }
 	//load this keyframe out of xml, which is alraedy pushed to the right level
 	//only need to save custom properties that our subclass adds
 	virtual void restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore);
+	virtual void restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues);
 	//save custom properties into the xml
     virtual void storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore);
+	//same for the binary format
+	virtual void restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader);
+	virtual void storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer);
 
 	//return keyframe at this mouse point if you have non circular keyframes
 	virtual ofxTLKeyframe* keyframeAtScreenpoint(ofVec2f p);
@@ -0,0 +1,182 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "ofxTLClock.h"
+
+#ifdef TARGET_WIN32
+#include <windows.h>
+#elif defined(TARGET_OSX)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#include <errno.h>
+#endif
+
+ofxTLClockStats::ofxTLClockStats(){
+	reset();
+}
+
+void ofxTLClockStats::reset(){
+	ticks = 0;
+	overruns = 0;
+	meanLatenessMicros = 0;
+	maxLatenessMicros = 0;
+	jitterMicros = 0;
+	latenessSum = 0;
+	latenessSquaredSum = 0;
+}
+
+void ofxTLClockStats::addTick(double latenessMicros){
+	ticks++;
+	latenessSum += latenessMicros;
+	latenessSquaredSum += latenessMicros*latenessMicros;
+	maxLatenessMicros = MAX(maxLatenessMicros, latenessMicros);
+	meanLatenessMicros = latenessSum / ticks;
+	jitterMicros = sqrt(MAX(0.0, latenessSquaredSum / ticks - meanLatenessMicros*meanLatenessMicros));
+}
+
+ofxTLClock::ofxTLClock()
+:	nextDeadline(0)
+{
+	setTickRate(1000);
+}
+
+unsigned long long ofxTLClock::getNanos(){
+#ifdef TARGET_WIN32
+	static LARGE_INTEGER frequency;
+	if(frequency.QuadPart == 0){
+		QueryPerformanceFrequency(&frequency);
+	}
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	//split so the multiply doesn't overflow
+	unsigned long long seconds = counter.QuadPart / frequency.QuadPart;
+	unsigned long long remainder = counter.QuadPart % frequency.QuadPart;
+	return seconds*1000000000ULL + remainder*1000000000ULL / frequency.QuadPart;
+#elif defined(TARGET_OSX)
+	static mach_timebase_info_data_t timebase;
+	if(timebase.denom == 0){
+		mach_timebase_info(&timebase);
+	}
+	return mach_absolute_time() * timebase.numer / timebase.denom;
+#else
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec*1000000000ULL + now.tv_nsec;
+#endif
+}
+
+double ofxTLClock::getSeconds(){
+	return getNanos() / 1000000000.0;
+}
+
+void ofxTLClock::sleepUntil(unsigned long long deadlineNanos){
+#ifdef TARGET_WIN32
+	//Sleep() only wakes on the scheduler tick, so sleep most of the way and spin the rest
+	const unsigned long long spinNanos = 2000000;
+	unsigned long long now = getNanos();
+	if(deadlineNanos > now + spinNanos){
+		Sleep(DWORD((deadlineNanos - now - spinNanos) / 1000000));
+	}
+	while(getNanos() < deadlineNanos){
+		SwitchToThread();
+	}
+#elif defined(TARGET_OSX)
+	static mach_timebase_info_data_t timebase;
+	if(timebase.denom == 0){
+		mach_timebase_info(&timebase);
+	}
+	mach_wait_until(deadlineNanos * timebase.denom / timebase.numer);
+#else
+	timespec deadline;
+	deadline.tv_sec = deadlineNanos / 1000000000ULL;
+	deadline.tv_nsec = deadlineNanos % 1000000000ULL;
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR){
+		//interrupted by a signal, the deadline is absolute so just wait again
+	}
+#endif
+}
+
+void ofxTLClock::setTickRate(double ticksPerSecond){
+	if(ticksPerSecond <= 0){
+		ofLogError("ofxTLClock::setTickRate") << "tick rate must be positive, not " << ticksPerSecond;
+		return;
+	}
+	statsLock.lock();
+	tickRate = ticksPerSecond;
+	periodNanos = 1000000000.0 / ticksPerSecond;
+	statsLock.unlock();
+}
+
+double ofxTLClock::getTickRate(){
+	return tickRate;
+}
+
+void ofxTLClock::start(){
+	statsLock.lock();
+	nextDeadline = getNanos() + periodNanos;
+	statsLock.unlock();
+}
+
+void ofxTLClock::waitForNextTick(){
+	statsLock.lock();
+	unsigned long long deadline = nextDeadline;
+	unsigned long long period = periodNanos;
+	statsLock.unlock();
+	
+	sleepUntil(deadline);
+	unsigned long long wokeAt = getNanos();
+	unsigned long long lateness = wokeAt > deadline ? wokeAt - deadline : 0;
+	
+	statsLock.lock();
+	stats.addTick(lateness / 1000.0);
+	nextDeadline = deadline + period;
+	//missed whole ticks, pick the rate up again from now rather than firing the missed ones back to back
+	if(wokeAt >= nextDeadline){
+		stats.overruns++;
+		nextDeadline = wokeAt + period - (wokeAt - deadline) % period;
+	}
+	statsLock.unlock();
+}
+
+ofxTLClockStats ofxTLClock::getStats(){
+	statsLock.lock();
+	ofxTLClockStats currentStats = stats;
+	statsLock.unlock();
+	return currentStats;
+}
+
+void ofxTLClock::resetStats(){
+	statsLock.lock();
+	stats.reset();
+	statsLock.unlock();
+}
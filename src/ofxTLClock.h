@@ -0,0 +1,90 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "ofMain.h"
+
+//how late a clock's ticks woke up compared to their deadlines
+class ofxTLClockStats {
+  public:
+	ofxTLClockStats();
+	void reset();
+	void addTick(double latenessMicros);
+	
+	unsigned long long ticks;
+	//ticks that woke up after the following tick was already due, the missed ticks are skipped
+	unsigned long long overruns;
+	double meanLatenessMicros;
+	double maxLatenessMicros;
+	//standard deviation of the lateness
+	double jitterMicros;
+	
+  protected:
+	double latenessSum;
+	double latenessSquaredSum;
+};
+
+//Paces a loop at a fixed tick rate from a monotonic high resolution clock.
+//Each tick waits for an absolute deadline rather than sleeping for a fixed amount,
+//so neither the work done per tick nor the OS sleep granularity make the rate drift.
+//Used by ofxTimeline's background thread, see ofxTimeline::moveToThread()
+class ofxTLClock {
+  public:
+	ofxTLClock();
+	
+	//time since an arbitrary fixed point, never jumps when the system clock is changed
+	static unsigned long long getNanos();
+	static double getSeconds();
+	//blocks until getNanos() reaches deadlineNanos
+	static void sleepUntil(unsigned long long deadlineNanos);
+	
+	//1000 ticks per second by default
+	void setTickRate(double ticksPerSecond);
+	double getTickRate();
+	
+	//the first tick is due one period from now
+	void start();
+	//waits for the next deadline and records how late the wake up was
+	void waitForNextTick();
+	
+	//safe to call from any thread while the clock is ticking
+	ofxTLClockStats getStats();
+	void resetStats();
+	
+  protected:
+	ofMutex statsLock;
+	double tickRate;
+	unsigned long long periodNanos;
+	unsigned long long nextDeadline;
+	ofxTLClockStats stats;
+};
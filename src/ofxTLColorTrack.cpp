@@ -35,16 +35,23 @@
 #include <cfloat>
 #include "ofxHotKeys.h"
 
+//the most colors kept for all the segments together, past this each segment gets fewer steps
+//a segment keeps at least its two ends, so past half a million keys there's no table and the palette is sampled directly
+static const int maxColorTableSize = 1 << 20;
+//steps along one segment, the longest path across a palette is rarely worth more
+static const int maxSegmentSteps = 64;
+
 ofxTLColorTrack::ofxTLColorTrack()
  :	drawingColorWindow(false),
 	clickedInColorRect(false),
 	defaultColor(ofColor(0,0,0)),
 	previousSample(NULL),
 	nextSample(NULL),
-	setNextAndPreviousOnUpdate(false)
-
+	setNextAndPreviousOnUpdate(false),
+	colorTableValid(false)
 {
-	//
+	//only the pixels are needed to sample, so palettes load without GL for headless timelines
+	colorPallete.setUseTexture(false);
 }
 
 void ofxTLColorTrack::draw(){
@@ -150,6 +157,10 @@ void ofxTLColorTrack::drawModalContent(){
 		if(colorWindow.getMaxX() > ofGetWidth()){
 			colorWindow.x -= colorWindow.width;
 		}
+		if(!colorPallete.getTextureReference().bAllocated()){
+			colorPallete.setUseTexture(true);
+			colorPallete.setFromPixels(palettePixels);
+		}
 		colorPallete.draw(colorWindow);
 
 		ofVec2f selectionPoint = colorWindow.getMin() + selectedSample->samplePoint * ofVec2f(colorWindow.width,colorWindow.height);
@@ -196,12 +207,14 @@ void ofxTLColorTrack::drawModalContent(){
 
 void ofxTLColorTrack::loadColorPalette(ofBaseHasPixels& image){
 	colorPallete.setFromPixels(image.getPixelsRef());
+	palettePixels = colorPallete.getPixelsRef();
 	refreshAllSamples();
 }
 
 bool ofxTLColorTrack::loadColorPalette(string imagePath){
 	if(colorPallete.loadImage(imagePath)){
 		palettePath = imagePath;
+		palettePixels = colorPallete.getPixelsRef();
 		refreshAllSamples();
 		return true;
 	}
@@ -223,6 +236,30 @@ ofColor ofxTLColorTrack::getColorAtPosition(float pos){
 }
 
 ofColor ofxTLColorTrack::getColorAtMillis(unsigned long long millis){
+	return getColorAtMillis(millis, &playbackCursor);
+}
+
+ofColor ofxTLColorTrack::getColorAtMillis(unsigned long long millis, ofxTLKeyframeCursor* cursor) const{
+	return sampleColorAtMillis(millis, cursor, hasColorTable());
+}
+
+void ofxTLColorTrack::getColorsInRange(unsigned long long startMillis, unsigned long long endMillis, int count, unsigned char* rgba) const{
+	if(count <= 0){
+		return;
+	}
+	double sampleStep = count > 1 ? (double(endMillis) - double(startMillis)) / (count - 1) : 0;
+	bool useColorTable = hasColorTable();
+	ofxTLKeyframeCursor cursor;
+	for(int i = 0; i < count; i++){
+		ofColor color = sampleColorAtMillis(startMillis + sampleStep*i, &cursor, useColorTable);
+		rgba[i*4+0] = color.r;
+		rgba[i*4+1] = color.g;
+		rgba[i*4+2] = color.b;
+		rgba[i*4+3] = color.a;
+	}
+}
+
+ofColor ofxTLColorTrack::sampleColorAtMillis(double millis, ofxTLKeyframeCursor* cursor, bool useColorTable) const{
 	if(keyframes.size() == 0){
 		return defaultColor;
 	}
@@ -236,16 +273,108 @@ ofColor ofxTLColorTrack::getColorAtMillis(unsigned long long millis){
 		return ((ofxTLColorSample*)keyframes[keyframes.size()-1])->color;
 	}
 
-	for(int i = 1; i < keyframes.size(); i++){
-		if(keyframes[i]->time >= millis){
-			ofxTLColorSample* startSample = (ofxTLColorSample*)keyframes[i-1];
-			ofxTLColorSample* endSample = (ofxTLColorSample*)keyframes[i];
-			float interpolationPosition = ofMap(millis, startSample->time, endSample->time, 0.0, 1.0);
-			return samplePaletteAtPosition(startSample->samplePoint.getInterpolated(endSample->samplePoint, interpolationPosition));
-		}
+	//keys are on whole millis so the first key after a fractional time is the first one after its ceiling
+	int i = keyframeIndexForTime(ceil(millis), cursor);
+	ofxTLColorSample* startSample = (ofxTLColorSample*)keyframes[i-1];
+	ofxTLColorSample* endSample = (ofxTLColorSample*)keyframes[i];
+	float interpolationPosition = ofMap(millis, startSample->time, endSample->time, 0.0, 1.0);
+	if(useColorTable){
+		return lookUpSegmentColor(i-1, interpolationPosition);
 	}
-	ofLogError("ofxTLColorTrack::getColorAtMillis") << "Could not find color for millis " << millis << endl;
-	return defaultColor;
+	return samplePaletteAtPosition(startSample->samplePoint.getInterpolated(endSample->samplePoint, interpolationPosition));
+}
+
+void ofxTLColorTrack::refreshColorTable(){
+	if(!hasColorTable()){
+		updateKeyframeColumns();
+	}
+}
+
+//keys added since the last sort aren't in the table yet
+bool ofxTLColorTrack::hasColorTable() const{
+	return colorTableValid && colorTableOffsets.size() == keyframes.size();
+}
+
+void ofxTLColorTrack::updateKeyframeColumns(){
+	ofxTLKeyframes::updateKeyframeColumns();
+	
+	colorTable.clear();
+	colorTableOffsets.clear();
+	//without a palette every sample is the default color and there's nothing to look up
+	colorTableValid = false;
+	int numSegments = keyframes.size() - 1;
+	int segmentSteps = maxSegmentStepsFor(numSegments);
+	if(!palettePixels.isAllocated() || segmentSteps <= 0){
+		return;
+	}
+	
+	colorTableOffsets.resize(keyframes.size());
+	for(int i = 0; i < numSegments; i++){
+		appendColorTableSegment(i, segmentSteps);
+	}
+	if(!keyframes.empty()){
+		colorTableOffsets.back() = colorTable.size();
+	}
+	colorTableValid = true;
+}
+
+void ofxTLColorTrack::keyframeAppended(ofxTLKeyframe* key){
+	ofxTLKeyframes::keyframeAppended(key);
+	//no table to extend, or it was already out of date before the key was added
+	if(!colorTableValid || colorTableOffsets.size() != keyframes.size()-1){
+		return;
+	}
+	if(keyframes.size() == 1){
+		colorTableOffsets.push_back(0);
+		return;
+	}
+	
+	//the new last segment gets the steps a rebuild would give it, as long as they fit under the cap
+	int segment = keyframes.size() - 2;
+	int segmentSteps = maxSegmentStepsFor(segment + 1);
+	if(segmentSteps <= 0 || colorTable.size() + segmentSteps + 1 > maxColorTableSize){
+		updateKeyframeColumns();
+		return;
+	}
+	appendColorTableSegment(segment, segmentSteps);
+	colorTableOffsets.push_back(colorTable.size());
+}
+
+//less than 1 when even one step a segment would go over the cap
+int ofxTLColorTrack::maxSegmentStepsFor(int numSegments) const{
+	if(numSegments <= 0){
+		return maxSegmentSteps;
+	}
+	return MIN(maxColorTableSize / numSegments - 1, maxSegmentSteps);
+}
+
+void ofxTLColorTrack::appendColorTableSegment(int segment, int segmentSteps){
+	ofVec2f paletteSize(palettePixels.getWidth(), palettePixels.getHeight());
+	ofxTLColorSample* startSample = (ofxTLColorSample*)keyframes[segment];
+	ofxTLColorSample* endSample = (ofxTLColorSample*)keyframes[segment+1];
+	int steps = ofClamp(ceil(((endSample->samplePoint - startSample->samplePoint) * paletteSize).length()), 1, segmentSteps);
+	colorTableOffsets[segment] = colorTable.size();
+	//the ends are the samples' own colors so keys look up exactly what they show
+	colorTable.push_back(startSample->color);
+	for(int s = 1; s < steps; s++){
+		colorTable.push_back(samplePaletteAtPosition(startSample->samplePoint.getInterpolated(endSample->samplePoint, float(s) / steps)));
+	}
+	colorTable.push_back(endSample->color);
+}
+
+//position is normalized along the segment
+ofColor ofxTLColorTrack::lookUpSegmentColor(int segment, float position) const{
+	int first = colorTableOffsets[segment];
+	int steps = colorTableOffsets[segment+1] - first - 1;
+	float step = ofClamp(position, 0, 1) * steps;
+	int s = MIN(int(step), steps - 1);
+	float amount = step - s;
+	const ofColor& a = colorTable[first + s];
+	const ofColor& b = colorTable[first + s + 1];
+	return ofColor(a.r + (b.r - a.r) * amount,
+				   a.g + (b.g - a.g) * amount,
+				   a.b + (b.b - a.b) * amount,
+				   a.a + (b.a - a.a) * amount);
 }
 
 void ofxTLColorTrack::setDefaultColor(ofColor color){
@@ -273,12 +402,14 @@ bool ofxTLColorTrack::mousePressed(ofMouseEventArgs& args, long millis){
 			selectedSample->samplePoint = ofVec2f(ofMap(args.x, colorWindow.getX(), colorWindow.getMaxX(), 0, 1.0-FLT_EPSILON, true),
 												  ofMap(args.y, colorWindow.getY(), colorWindow.getMaxY(), 0, 1.0-FLT_EPSILON, true));
 			refreshSample(selectedSample);
+			refreshColorTable();
 			shouldRecomputePreviews = true;
 		}
 		else if(args.button == 0 && previousColorRect.inside(args.x, args.y)){
 			ofxTLColorSample* selectedSample = (ofxTLColorSample*)selectedKeyframe;
 			selectedSample->samplePoint = samplePositionAtClickTime;
 			refreshSample(selectedSample);
+			refreshColorTable();
 			clickedInColorRect = true; //keep the window open
 			shouldRecomputePreviews = true;
 		}
@@ -297,6 +428,7 @@ void ofxTLColorTrack::mouseDragged(ofMouseEventArgs& args, long millis){
 			selectedSample->samplePoint = ofVec2f(ofMap(args.x, colorWindow.getX(), colorWindow.getMaxX(), 0, 1.0-FLT_EPSILON,true),
 												  ofMap(args.y, colorWindow.getY(), colorWindow.getMaxY(), 0, 1.0-FLT_EPSILON,true));
 			refreshSample(selectedSample);
+			refreshColorTable();
 			shouldRecomputePreviews = true;
 		}
 	}
@@ -364,7 +496,7 @@ void ofxTLColorTrack::updatePreviewPalette(){
 }
 
 ofxTLKeyframe* ofxTLColorTrack::newKeyframe(){
-	ofxTLColorSample* sample = new ofxTLColorSample();
+	ofxTLColorSample* sample = createKeyframe<ofxTLColorSample>();
 	sample->samplePoint = ofVec2f(.5,.5);
 	sample->color = defaultColor;
 	//when creating a new keyframe select it and draw a color window
@@ -385,8 +517,23 @@ void ofxTLColorTrack::restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlSto
 								  xmlStore.getValue("sampleY", 0.0));
 
 	//for pasted keyframes cancel the color window
-	drawingColorWindow = false;
-	timeline->dismissedModalContent();
+	//only when it's open, this also runs while loading on a worker thread
+	if(drawingColorWindow){
+		drawingColorWindow = false;
+		timeline->dismissedModalContent();
+	}
+	refreshSample(sample);
+}
+
+void ofxTLColorTrack::restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues){
+	ofxTLColorSample* sample = (ofxTLColorSample*)key;
+	sample->samplePoint = ofVec2f(keyValues.getValue("sampleX", 0.0),
+								  keyValues.getValue("sampleY", 0.0));
+	
+	if(drawingColorWindow){
+		drawingColorWindow = false;
+		timeline->dismissedModalContent();
+	}
 	refreshSample(sample);
 }
 
@@ -396,6 +543,24 @@ void ofxTLColorTrack::storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore
 	xmlStore.setValue("sampleY", sample->samplePoint.y);
 }
 
+void ofxTLColorTrack::restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader){
+	ofxTLColorSample* sample = (ofxTLColorSample*)key;
+	sample->samplePoint.x = reader.readFloat();
+	sample->samplePoint.y = reader.readFloat();
+	
+	if(drawingColorWindow){
+		drawingColorWindow = false;
+		timeline->dismissedModalContent();
+	}
+	refreshSample(sample);
+}
+
+void ofxTLColorTrack::storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer){
+	ofxTLColorSample* sample = (ofxTLColorSample*)key;
+	writer.writeFloat(sample->samplePoint.x);
+	writer.writeFloat(sample->samplePoint.y);
+}
+
 void ofxTLColorTrack::regionSelected(ofLongRange timeRange, ofRange valueRange){
     for(int i = 0; i < keyframes.size(); i++){
     	if(timeRange.contains( keyframes[i]->time )){
@@ -449,25 +614,27 @@ void ofxTLColorTrack::refreshAllSamples(){
 	for(int i = 0; i < keyframes.size(); i++){
 		refreshSample((ofxTLColorSample*)keyframes[i]);
 	}
+	refreshColorTable();
 	shouldRecomputePreviews = true;
 }
 
 void ofxTLColorTrack::refreshSample(ofxTLColorSample* sample){
 	sample->color = samplePaletteAtPosition(sample->samplePoint);
+	colorTableValid = false;
 }
 
 //assumes normalized position
-ofColor ofxTLColorTrack::samplePaletteAtPosition(ofVec2f position){
-	if(colorPallete.bAllocated()){
-		ofVec2f positionPixelSpace = position * ofVec2f(colorPallete.getWidth(),colorPallete.getHeight());
+ofColor ofxTLColorTrack::samplePaletteAtPosition(ofVec2f position) const{
+	if(palettePixels.isAllocated()){
+		ofVec2f positionPixelSpace = position * ofVec2f(palettePixels.getWidth(),palettePixels.getHeight());
 		//bilinear interpolation from http://www.gamedev.net/page/resources/_/technical/graphics-programming-and-theory/bilinear-interpolation-of-texture-maps-r810
 		int x0 = int(positionPixelSpace.x);
 		int y0 = int(positionPixelSpace.y);
 		float dx = positionPixelSpace.x-x0, dy = positionPixelSpace.y-y0, omdx = 1-dx, omdy = 1-dy;
-		return colorPallete.getPixelsRef().getColor(x0,y0)*omdx*omdy +
-	           colorPallete.getPixelsRef().getColor(x0,MIN(y0+1, colorPallete.getHeight()-1))*omdx*dy +
-               colorPallete.getPixelsRef().getColor(MIN(x0+1,colorPallete.getWidth()-1),y0)*dx*omdy +
-			   colorPallete.getPixelsRef().getColor(MIN(x0+1,colorPallete.getWidth()-1),MIN(y0+1, colorPallete.getHeight()-1))*dx*dy;
+		return palettePixels.getColor(x0,y0)*omdx*omdy +
+	           palettePixels.getColor(x0,MIN(y0+1, palettePixels.getHeight()-1))*omdx*dy +
+               palettePixels.getColor(MIN(x0+1,palettePixels.getWidth()-1),y0)*dx*omdy +
+			   palettePixels.getColor(MIN(x0+1,palettePixels.getWidth()-1),MIN(y0+1, palettePixels.getHeight()-1))*dx*dy;
 	}
 	else{
 		ofLogError("ofxTLColorTrack::refreshSample -- sampling palette is null");
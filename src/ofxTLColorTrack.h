@@ -56,6 +56,7 @@ class ofxTLColorTrack : public ofxTLKeyframes {
 	virtual void keyPressed(ofKeyEventArgs& args);
 
     virtual string getTrackType();
+    virtual bool supportsUndoDeltas(){ return false; }
 	
 	virtual void loadColorPalette(ofBaseHasPixels& image);
 	virtual bool loadColorPalette(string imagePath);
@@ -65,6 +66,14 @@ class ofxTLColorTrack : public ofxTLKeyframes {
 	ofColor getColorAtSecond(float second);
 	ofColor getColorAtMillis(unsigned long long millis);
 	ofColor getColorAtPosition(float pos);
+	//thread safe sampling, see ofxTLKeyframes::getValueAtTimeInMillis
+	ofColor getColorAtMillis(unsigned long long millis, ofxTLKeyframeCursor* cursor) const;
+	//fills rgba with count colors spaced evenly from startMillis to endMillis, both included, four bytes a color
+	//thread safe like the cursor version, for filling pixel maps
+	void getColorsInRange(unsigned long long startMillis, unsigned long long endMillis, int count, unsigned char* rgba) const;
+	//sampling looks colors up in a table rebuilt when the keys are sorted, a sample is edited or the palette changes
+	//until then every getter samples the palette directly. rebuilds it now if it's out of date
+	void refreshColorTable();
 
 	virtual void setDefaultColor(ofColor color);
 	virtual ofColor getDefaultColor();
@@ -73,8 +82,11 @@ class ofxTLColorTrack : public ofxTLKeyframes {
   protected:
 	ofImage colorPallete;
 	ofImage previewPalette;
+	ofPixels palettePixels; //sampled from instead of the image so sampling can be const
 	string palettePath;
 	
+	//colors are sampled from the keyframe objects
+	virtual bool canSampleMappedKeys() const { return false; }
 	virtual void updatePreviewPalette();
 	virtual ofxTLKeyframe* newKeyframe();
     virtual ofxTLKeyframe* keyframeAtScreenpoint(ofVec2f p);
@@ -89,7 +101,10 @@ class ofxTLColorTrack : public ofxTLKeyframes {
 	ofRectangle newColorRect;
 	
     virtual void restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore);
+	virtual void restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues);
 	virtual void storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore);
+	virtual void restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader);
+	virtual void storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer);
     virtual void selectedKeySecondaryClick(ofMouseEventArgs& args);
 	
 	void refreshAllSamples();
@@ -98,7 +113,21 @@ class ofxTLColorTrack : public ofxTLKeyframes {
 	ofxTLColorSample* previousSample;
 	ofxTLColorSample* nextSample;
 	void refreshSample(ofxTLColorSample* sample);
-	ofColor samplePaletteAtPosition(ofVec2f position);
+	ofColor samplePaletteAtPosition(ofVec2f position) const;
+	ofColor sampleColorAtMillis(double millis, ofxTLKeyframeCursor* cursor, bool useColorTable) const;
+	
+	//the palette colors along each segment's path from one sample to the next, about a palette pixel apart
+	//segment i runs from key i to key i+1, its colors are colorTable[colorTableOffsets[i]] up to colorTable[colorTableOffsets[i+1]]
+	virtual void updateKeyframeColumns();
+	//adds the new last segment to the table instead of rebuilding it
+	virtual void keyframeAppended(ofxTLKeyframe* key);
+	int maxSegmentStepsFor(int numSegments) const;
+	void appendColorTableSegment(int segment, int segmentSteps);
+	bool hasColorTable() const;
+	ofColor lookUpSegmentColor(int segment, float position) const;
+	vector<ofColor> colorTable;
+	vector<int> colorTableOffsets;
+	bool colorTableValid;
 	
 	ofColor defaultColor;
 	
@@ -35,17 +35,105 @@
 #include "ofxHotKeys.h"
 
 ofxTLCurves::ofxTLCurves(){
+	compiledSegmentsValid = false;
 	initializeEasings();
 	valueRange = ofRange(0.0, 1.0);
 	drawingEasingWindow = false;
 }
 
-float ofxTLCurves::interpolateValueForKeys(ofxTLKeyframe* start,ofxTLKeyframe* end, unsigned long long sampleTime){
+float ofxTLCurves::interpolateValueForKeys(ofxTLKeyframe* start,ofxTLKeyframe* end, unsigned long long sampleTime) const{
 	ofxTLTweenKeyframe* tweenKeyStart = (ofxTLTweenKeyframe*)start;
-	ofxTLTweenKeyframe* tweenKeyEnd = (ofxTLTweenKeyframe*)end;
-	return ofxTween::map(sampleTime, tweenKeyStart->time, tweenKeyEnd->time,
-						 			 tweenKeyStart->value, tweenKeyEnd->value,
-						 false, *tweenKeyStart->easeFunc->easing, tweenKeyStart->easeType->type);
+	if(end->time == start->time){
+		return end->value;
+	}
+	float x = (double(sampleTime) - start->time) / (double(end->time) - start->time);
+	return start->value + (end->value - start->value) * tweenKeyStart->easeFunc->kernels.ease[tweenKeyStart->easeType->type](x);
+}
+
+//same as calling interpolateValueForKeys for each sample, but picks the easing once per run
+//and hands the whole run to its kernel where the easing is inlined
+void ofxTLCurves::interpolateValuesForKeys(ofxTLKeyframe* start, ofxTLKeyframe* end, double firstSampleTime, double sampleStep, int count, float* samples) const{
+	ofxTLTweenKeyframe* tweenKeyStart = (ofxTLTweenKeyframe*)start;
+	if(end->time == start->time){
+		ofxTLKeyframes::interpolateValuesForKeys(start, end, firstSampleTime, sampleStep, count, samples);
+		return;
+	}
+	double duration = double(end->time) - start->time;
+	tweenKeyStart->easeFunc->kernels.easeRun[tweenKeyStart->easeType->type]((firstSampleTime - start->time) / duration, sampleStep / duration,
+																			 count, start->value, end->value - start->value, samples);
+}
+
+//the compiled segment, when there is one, is the whole interpolation without touching the keys
+float ofxTLCurves::interpolateKeysAtIndices(int startIndex, int endIndex, unsigned long long sampleTime) const{
+	if(!hasCompiledSegments()){
+		return interpolateValueForKeys(keyframes[startIndex], keyframes[endIndex], sampleTime);
+	}
+	const ofxTLCurveSegment& segment = compiledSegments[startIndex];
+	float x = (sampleTime - segment.startTime) * segment.inverseDuration;
+	if(segment.ease == NULL){
+		return segment.startValue + segment.valueChange * x;
+	}
+	return segment.startValue + segment.valueChange * segment.ease(x);
+}
+
+void ofxTLCurves::refreshCompiledSegments(){
+	if(!hasCompiledSegments()){
+		updateKeyframeColumns();
+	}
+}
+
+//keys added since the last sort aren't compiled yet, and the segments are looked up through the key columns
+bool ofxTLCurves::hasCompiledSegments() const{
+	return compiledSegmentsValid && hasKeyColumns() && compiledSegments.size() + 1 == keyframes.size();
+}
+
+void ofxTLCurves::updateKeyframeColumns(){
+	ofxTLKeyframes::updateKeyframeColumns();
+	
+	compiledSegments.resize(MAX((int)keyframes.size() - 1, 0));
+	for(int i = 0; i < compiledSegments.size(); i++){
+		compileSegment(i);
+	}
+	compiledSegmentsValid = true;
+}
+
+void ofxTLCurves::keyframeAppended(ofxTLKeyframe* key){
+	ofxTLKeyframes::keyframeAppended(key);
+	//only the new last segment needs compiling if the rest are up to date
+	int numSegmentsBefore = MAX((int)keyframes.size() - 2, 0);
+	if(!compiledSegmentsValid || compiledSegments.size() != numSegmentsBefore){
+		updateKeyframeColumns();
+		return;
+	}
+	if(keyframes.size() > 1){
+		compiledSegments.push_back(ofxTLCurveSegment());
+		compileSegment(compiledSegments.size() - 1);
+	}
+}
+
+void ofxTLCurves::compileSegment(int i){
+	ofxTLTweenKeyframe* start = (ofxTLTweenKeyframe*)keyframes[i];
+	ofxTLKeyframe* end = keyframes[i+1];
+	ofxTLCurveSegment& segment = compiledSegments[i];
+	segment.startTime = start->time;
+	//keys only share a time until the sort separates them, such a segment is never sampled inside
+	segment.inverseDuration = end->time > start->time ? 1.0 / (end->time - start->time) : 0;
+	segment.startValue = start->value;
+	segment.valueChange = end->value - start->value;
+	segment.ease = start->easeFunc == easingFunctions[0] ? NULL : start->easeFunc->kernels.ease[start->easeType->type];
+}
+
+//reads the start key's easing out of its payload, in the layout written by storeKeyframeBinary
+float ofxTLCurves::interpolateMappedKeys(int startIndex, int endIndex, unsigned long long sampleTime) const{
+	ofxTLTweenKeyframe start, end;
+	start.time = mappedTimes[startIndex];
+	start.value = mappedValues[startIndex];
+	end.time = mappedTimes[endIndex];
+	end.value = mappedValues[endIndex];
+	ofxTLBinaryReader payload = getMappedPayload(startIndex);
+	start.easeFunc = easingFunctions[ofClamp(payload.readUInt8(), 0, easingFunctions.size()-1)];
+	start.easeType = easingTypes[ofClamp(payload.readUInt8(), 0, easingTypes.size()-1)];
+	return interpolateValueForKeys(&start, &end, sampleTime);
 }
 
 string ofxTLCurves::getTrackType(){
@@ -53,7 +141,7 @@ string ofxTLCurves::getTrackType(){
 }
 
 ofxTLKeyframe* ofxTLCurves::newKeyframe(){
-	ofxTLTweenKeyframe* k = new ofxTLTweenKeyframe();
+	ofxTLTweenKeyframe* k = createKeyframe<ofxTLTweenKeyframe>();
 	k->easeFunc = easingFunctions[0];
 	k->easeType = easingTypes[0];
 	return k;
@@ -157,8 +245,10 @@ void ofxTLCurves::mouseReleased(ofMouseEventArgs& args, long millis){
 		for(int i = 0; i < easingFunctions.size(); i++){
 			if(easingFunctions[i]->bounds.inside(screenpoint-easingWindowPosition)){
 				for(int k = 0; k < selectedKeyframes.size(); k++){
+					keyframeWillChange(selectedKeyframes[k]);
 					((ofxTLTweenKeyframe*)selectedKeyframes[k])->easeFunc = easingFunctions[i];
 				}
+				updateKeyframeColumns();
 				timeline->flagTrackModified(this);
 				shouldRecomputePreviews = true;
 				return;
@@ -168,8 +258,10 @@ void ofxTLCurves::mouseReleased(ofMouseEventArgs& args, long millis){
 		for(int i = 0; i < easingTypes.size(); i++){
 			if(easingTypes[i]->bounds.inside(screenpoint-easingWindowPosition)){
 				for(int k = 0; k < selectedKeyframes.size(); k++){
+					keyframeWillChange(selectedKeyframes[k]);
 					((ofxTLTweenKeyframe*)selectedKeyframes[k])->easeType = easingTypes[i];
 				}
+				updateKeyframeColumns();
 				timeline->flagTrackModified(this);
 				shouldRecomputePreviews = true;
 				return;
@@ -199,6 +291,7 @@ void ofxTLCurves::restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore){
     ofxTLTweenKeyframe* tweenKey =  (ofxTLTweenKeyframe*)key;    
     tweenKey->easeFunc = easingFunctions[ofClamp(xmlStore.getValue("easefunc", 0), 0, easingFunctions.size()-1)];
     tweenKey->easeType = easingTypes[ofClamp(xmlStore.getValue("easetype", 0), 0, easingTypes.size()-1)];
+	compiledSegmentsValid = false;
 }
 
 void ofxTLCurves::storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore){
@@ -207,62 +300,94 @@ void ofxTLCurves::storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore){
     xmlStore.addValue("easetype", tweenKey->easeType->id);
 }
 
+//same as restoreKeyframe, without going through a document
+void ofxTLCurves::restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues){
+    ofxTLTweenKeyframe* tweenKey =  (ofxTLTweenKeyframe*)key;
+    tweenKey->easeFunc = easingFunctions[ofClamp(keyValues.getValue("easefunc", 0), 0, easingFunctions.size()-1)];
+    tweenKey->easeType = easingTypes[ofClamp(keyValues.getValue("easetype", 0), 0, easingTypes.size()-1)];
+	compiledSegmentsValid = false;
+}
+
+void ofxTLCurves::restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader){
+    ofxTLTweenKeyframe* tweenKey =  (ofxTLTweenKeyframe*)key;
+    tweenKey->easeFunc = easingFunctions[ofClamp(reader.readUInt8(), 0, easingFunctions.size()-1)];
+    tweenKey->easeType = easingTypes[ofClamp(reader.readUInt8(), 0, easingTypes.size()-1)];
+	compiledSegmentsValid = false;
+}
+
+void ofxTLCurves::storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer){
+    ofxTLTweenKeyframe* tweenKey =  (ofxTLTweenKeyframe*)key;
+    writer.writeUInt8(tweenKey->easeFunc->id);
+    writer.writeUInt8(tweenKey->easeType->id);
+}
+
 void ofxTLCurves::initializeEasings(){
     
 	//FUNCTIONS ----
 	EasingFunction* ef;
 	ef = new EasingFunction();
 	ef->easing = new ofxEasingLinear();
+	ef->kernels = ofxTLMakeEasingKernels<ofxTLEasingLinear>();
 	ef->name = "linear";
 	easingFunctions.push_back(ef);
 	
 	ef = new EasingFunction();
 	ef->easing = new ofxEasingSine();
+	ef->kernels = ofxTLMakeEasingKernels<ofxTLEasingSine>();
 	ef->name = "sine";
 	easingFunctions.push_back(ef);
     
 	ef = new EasingFunction();
 	ef->easing = new ofxEasingCirc();
+	ef->kernels = ofxTLMakeEasingKernels<ofxTLEasingCirc>();
 	ef->name = "circular";
 	easingFunctions.push_back(ef);
     
 	ef = new EasingFunction();
 	ef->easing = new ofxEasingQuad();
+	ef->kernels = ofxTLMakeEasingKernels<ofxTLEasingQuad>();
 	ef->name = "quadratic";
 	easingFunctions.push_back(ef);
 	
 	ef = new EasingFunction();
 	ef->easing = new ofxEasingCubic();
+	ef->kernels = ofxTLMakeEasingKernels<ofxTLEasingCubic>();
 	ef->name = "cubic";
 	easingFunctions.push_back(ef);
     
 	ef = new EasingFunction();
 	ef->easing = new ofxEasingQuart();
+	ef->kernels = ofxTLMakeEasingKernels<ofxTLEasingQuart>();
 	ef->name = "quartic";
 	easingFunctions.push_back(ef);
 	
 	ef = new EasingFunction();
 	ef->easing = new ofxEasingQuint();
+	ef->kernels = ofxTLMakeEasingKernels<ofxTLEasingQuint>();
 	ef->name = "quintic";
 	easingFunctions.push_back(ef);
     
 	ef = new EasingFunction();
 	ef->easing = new ofxEasingExpo();
+	ef->kernels = ofxTLMakeEasingKernels<ofxTLEasingExpo>();
 	ef->name = "exponential";
 	easingFunctions.push_back(ef);
 	
 	ef = new EasingFunction();
 	ef->easing = new ofxEasingBack();
+	ef->kernels = ofxTLMakeEasingKernels<ofxTLEasingBack>();
 	ef->name = "back";
 	easingFunctions.push_back(ef);
     
 	ef = new EasingFunction();
 	ef->easing = new ofxEasingBounce();
+	ef->kernels = ofxTLMakeEasingKernels<ofxTLEasingBounce>();
 	ef->name = "bounce";
 	easingFunctions.push_back(ef);
     
 	ef = new EasingFunction();
 	ef->easing = new ofxEasingElastic();
+	ef->kernels = ofxTLMakeEasingKernels<ofxTLEasingElastic>();
 	ef->name = "elastic";
 	easingFunctions.push_back(ef);
     
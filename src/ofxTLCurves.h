@@ -36,6 +36,7 @@
 #include "ofMain.h"
 #include "ofxTLKeyframes.h"
 #include "ofxTween.h"
+#include "ofxTLEasing.h"
 
 typedef struct {
 	int id;
@@ -46,6 +47,8 @@ typedef struct {
 	ofPolyline easeInOutPreview;
 	
 	ofxEasing* easing;
+	//the same easing for sampling, see ofxTLEasing.h
+	ofxTLEasingKernels kernels;
 } EasingFunction;
 
 typedef struct {
@@ -55,6 +58,16 @@ typedef struct {
 	ofxTween::ofxEasingType type;
 } EasingType;
 
+//one segment between two keys ready to sample, value is startValue + valueChange * ease(x)
+//where x = (time - startTime) * inverseDuration, a linear segment has no ease function
+typedef struct {
+	unsigned long long startTime;
+	double inverseDuration;
+	float startValue;
+	float valueChange;
+	ofxTLEaseFunction ease;
+} ofxTLCurveSegment;
+
 class ofxTLTweenKeyframe : public ofxTLKeyframe{
   public:
     EasingFunction* easeFunc;
@@ -75,15 +88,36 @@ class ofxTLCurves : public ofxTLKeyframes {
 	virtual void mouseReleased(ofMouseEventArgs& args, long millis);
 	
     virtual string getTrackType();
+	//easings are looked up in tables built in the constructor, so curves can load on a worker thread
+	virtual bool canLoadOnThread(){ return true; }
+	
+	//sampling reads the compiled segments, rebuilt with the key columns and when an easing changes
+	//until then it interpolates the keys directly. rebuilds them now if they're out of date
+	void refreshCompiledSegments();
     
   protected:
 	
     virtual ofxTLKeyframe* newKeyframe();
     virtual void restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore);
 	virtual void storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore);
+	virtual void restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues);
+	virtual void restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader);
+	virtual void storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer);
     
     virtual void selectedKeySecondaryClick(ofMouseEventArgs& args);	
-	virtual float interpolateValueForKeys(ofxTLKeyframe* start,ofxTLKeyframe* end, unsigned long long sampleTime);
+	virtual float interpolateValueForKeys(ofxTLKeyframe* start,ofxTLKeyframe* end, unsigned long long sampleTime) const;
+	virtual void interpolateValuesForKeys(ofxTLKeyframe* start, ofxTLKeyframe* end, double firstSampleTime, double sampleStep, int count, float* samples) const;
+	virtual float interpolateMappedKeys(int startIndex, int endIndex, unsigned long long sampleTime) const;
+	virtual float interpolateKeysAtIndices(int startIndex, int endIndex, unsigned long long sampleTime) const;
+	
+	//segment i runs from key i to key i+1
+	virtual void updateKeyframeColumns();
+	//compiles just the new last segment
+	virtual void keyframeAppended(ofxTLKeyframe* key);
+	void compileSegment(int i);
+	bool hasCompiledSegments() const;
+	vector<ofxTLCurveSegment> compiledSegments;
+	bool compiledSegmentsValid;
 	
 	//easing dialog stuff
     void initializeEasings();
@@ -0,0 +1,253 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxTween.h"
+
+//Robert Penner's easing equations the way ofxEasing writes them, rewritten on the fraction x of the way
+//through a segment so each returns the fraction of the way from the segment's start value to its end.
+//they're plain static functions so a loop over one of them compiles inline,
+//where ofxTween::map calls a virtual easing and switches on the ease type for every sample
+
+struct ofxTLEasingLinear {
+	static inline float easeIn(float x){ return x; }
+	static inline float easeOut(float x){ return x; }
+	static inline float easeInOut(float x){ return x; }
+};
+
+struct ofxTLEasingSine {
+	static inline float easeIn(float x){ return 1 - cos(x * (PI/2)); }
+	static inline float easeOut(float x){ return sin(x * (PI/2)); }
+	static inline float easeInOut(float x){ return -.5f * (cos(PI*x) - 1); }
+};
+
+struct ofxTLEasingCirc {
+	static inline float easeIn(float x){ return 1 - sqrt(1 - x*x); }
+	static inline float easeOut(float x){ x -= 1; return sqrt(1 - x*x); }
+	static inline float easeInOut(float x){
+		x *= 2;
+		if(x < 1){
+			return -.5f * (sqrt(1 - x*x) - 1);
+		}
+		x -= 2;
+		return .5f * (sqrt(1 - x*x) + 1);
+	}
+};
+
+struct ofxTLEasingQuad {
+	static inline float easeIn(float x){ return x*x; }
+	static inline float easeOut(float x){ return -x*(x-2); }
+	static inline float easeInOut(float x){
+		x *= 2;
+		if(x < 1){
+			return .5f*x*x;
+		}
+		x -= 1;
+		return -.5f * (x*(x-2) - 1);
+	}
+};
+
+struct ofxTLEasingCubic {
+	static inline float easeIn(float x){ return x*x*x; }
+	static inline float easeOut(float x){ x -= 1; return x*x*x + 1; }
+	static inline float easeInOut(float x){
+		x *= 2;
+		if(x < 1){
+			return .5f*x*x*x;
+		}
+		x -= 2;
+		return .5f * (x*x*x + 2);
+	}
+};
+
+struct ofxTLEasingQuart {
+	static inline float easeIn(float x){ return x*x*x*x; }
+	static inline float easeOut(float x){ x -= 1; return -(x*x*x*x - 1); }
+	static inline float easeInOut(float x){
+		x *= 2;
+		if(x < 1){
+			return .5f*x*x*x*x;
+		}
+		x -= 2;
+		return -.5f * (x*x*x*x - 2);
+	}
+};
+
+struct ofxTLEasingQuint {
+	static inline float easeIn(float x){ return x*x*x*x*x; }
+	static inline float easeOut(float x){ x -= 1; return x*x*x*x*x + 1; }
+	static inline float easeInOut(float x){
+		x *= 2;
+		if(x < 1){
+			return .5f*x*x*x*x*x;
+		}
+		x -= 2;
+		return .5f * (x*x*x*x*x + 2);
+	}
+};
+
+struct ofxTLEasingExpo {
+	static inline float easeIn(float x){ return x == 0 ? 0 : pow(2.f, 10 * (x - 1)); }
+	static inline float easeOut(float x){ return x == 1 ? 1 : 1 - pow(2.f, -10 * x); }
+	static inline float easeInOut(float x){
+		if(x == 0) return 0;
+		if(x == 1) return 1;
+		x *= 2;
+		if(x < 1){
+			return .5f * pow(2.f, 10 * (x - 1));
+		}
+		x -= 1;
+		return .5f * (2 - pow(2.f, -10 * x));
+	}
+};
+
+struct ofxTLEasingBack {
+	static inline float easeIn(float x){
+		const float s = 1.70158f;
+		return x*x*((s+1)*x - s);
+	}
+	static inline float easeOut(float x){
+		const float s = 1.70158f;
+		x -= 1;
+		return x*x*((s+1)*x + s) + 1;
+	}
+	static inline float easeInOut(float x){
+		const float s = 1.70158f * 1.525f;
+		x *= 2;
+		if(x < 1){
+			return .5f * (x*x*((s+1)*x - s));
+		}
+		x -= 2;
+		return .5f * (x*x*((s+1)*x + s) + 2);
+	}
+};
+
+struct ofxTLEasingBounce {
+	static inline float easeOut(float x){
+		if(x < 1/2.75f){
+			return 7.5625f*x*x;
+		}
+		else if(x < 2/2.75f){
+			x -= 1.5f/2.75f;
+			return 7.5625f*x*x + .75f;
+		}
+		else if(x < 2.5f/2.75f){
+			x -= 2.25f/2.75f;
+			return 7.5625f*x*x + .9375f;
+		}
+		x -= 2.625f/2.75f;
+		return 7.5625f*x*x + .984375f;
+	}
+	static inline float easeIn(float x){ return 1 - easeOut(1 - x); }
+	static inline float easeInOut(float x){
+		if(x < .5f){
+			return .5f * easeIn(x*2);
+		}
+		return .5f * easeOut(x*2 - 1) + .5f;
+	}
+};
+
+//the period and its quarter are fractions of the segment, so the duration drops out
+struct ofxTLEasingElastic {
+	static inline float easeIn(float x){
+		if(x == 0) return 0;
+		if(x == 1) return 1;
+		const float p = .3f;
+		x -= 1;
+		return -(pow(2.f, 10 * x) * sin((x - p/4) * (2*PI) / p));
+	}
+	static inline float easeOut(float x){
+		if(x == 0) return 0;
+		if(x == 1) return 1;
+		const float p = .3f;
+		return pow(2.f, -10 * x) * sin((x - p/4) * (2*PI) / p) + 1;
+	}
+	static inline float easeInOut(float x){
+		if(x == 0) return 0;
+		x *= 2;
+		if(x == 2) return 1;
+		const float p = .3f * 1.5f;
+		x -= 1;
+		if(x < 0){
+			return -.5f * (pow(2.f, 10 * x) * sin((x - p/4) * (2*PI) / p));
+		}
+		return pow(2.f, -10 * x) * sin((x - p/4) * (2*PI) / p) * .5f + 1;
+	}
+};
+
+//in, out or in and out of an easing, chosen at compile time
+template<class Easing, int EaseType> struct ofxTLEase {
+	static inline float ease(float x){ return Easing::easeInOut(x); }
+};
+template<class Easing> struct ofxTLEase<Easing, ofxTween::easeIn> {
+	static inline float ease(float x){ return Easing::easeIn(x); }
+};
+template<class Easing> struct ofxTLEase<Easing, ofxTween::easeOut> {
+	static inline float ease(float x){ return Easing::easeOut(x); }
+};
+
+typedef float (*ofxTLEaseFunction)(float x);
+//fills count samples of a segment whose value goes from startValue to startValue+valueChange
+//the first sample is firstX of the way through it and each one after is xStep further
+typedef void (*ofxTLEaseRunFunction)(double firstX, double xStep, int count, float startValue, float valueChange, float* samples);
+
+template<class Easing, int EaseType>
+float ofxTLEaseSample(float x){
+	return ofxTLEase<Easing, EaseType>::ease(x);
+}
+
+template<class Easing, int EaseType>
+void ofxTLEaseRun(double firstX, double xStep, int count, float startValue, float valueChange, float* samples){
+	for(int i = 0; i < count; i++){
+		samples[i] = startValue + valueChange * ofxTLEase<Easing, EaseType>::ease(firstX + xStep*i);
+	}
+}
+
+//an easing's functions indexed by ofxTween::ofxEasingType, looked up once per segment
+struct ofxTLEasingKernels {
+	ofxTLEaseFunction ease[3];
+	ofxTLEaseRunFunction easeRun[3];
+};
+
+template<class Easing>
+ofxTLEasingKernels ofxTLMakeEasingKernels(){
+	ofxTLEasingKernels kernels;
+	kernels.ease[ofxTween::easeIn] = &ofxTLEaseSample<Easing, ofxTween::easeIn>;
+	kernels.ease[ofxTween::easeOut] = &ofxTLEaseSample<Easing, ofxTween::easeOut>;
+	kernels.ease[ofxTween::easeInOut] = &ofxTLEaseSample<Easing, ofxTween::easeInOut>;
+	kernels.easeRun[ofxTween::easeIn] = &ofxTLEaseRun<Easing, ofxTween::easeIn>;
+	kernels.easeRun[ofxTween::easeOut] = &ofxTLEaseRun<Easing, ofxTween::easeOut>;
+	kernels.easeRun[ofxTween::easeInOut] = &ofxTLEaseRun<Easing, ofxTween::easeInOut>;
+	return kernels;
+}
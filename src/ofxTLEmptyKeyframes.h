@@ -79,11 +79,14 @@ class ofxTLEmptyKeyframes : public ofxTLKeyframes {
 
 	//return a custom name for this keyframe
 	virtual string getTrackType();
+	virtual bool supportsUndoDeltas(){ return false; }
 
   protected:
 	//always return the type for your track, in our case ofxTLEmptyKeyframe;
 	//this will enusre that all keyframe objects passed to this class are of this type
 	virtual ofxTLKeyframe* newKeyframe();
+	//this track draws and samples its keyframe objects directly, so it can't be sampled from a mapped file
+	virtual bool canSampleMappedKeys() const { return false; }
 	//load this keyframe out of xml, which is alraedy pushed to the right level
 	//only need to save custom properties that our subclass adds
 	virtual void restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore);
@@ -0,0 +1,143 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "ofxTLEventQueue.h"
+
+#include "ofxTLAtomic.h"
+
+ofxTLEventQueue::ofxTLEventQueue()
+:	mask(0),
+	pushPosition(0),
+	popPosition(0),
+	numOverflowed(0),
+	numDropped(0)
+{
+	allocate(1024);
+}
+
+void ofxTLEventQueue::allocate(int size){
+	clear();
+	int capacity = 2;
+	while(capacity < size){
+		capacity *= 2;
+	}
+	slots.resize(capacity);
+	for(int i = 0; i < capacity; i++){
+		slots[i].sequence = i;
+	}
+	mask = capacity-1;
+	pushPosition = 0;
+	popPosition = 0;
+}
+
+int ofxTLEventQueue::getCapacity(){
+	return slots.size();
+}
+
+bool ofxTLEventQueue::push(const ofxTLQueuedEvent& event){
+	unsigned int position = pushPosition;
+	Slot* slot;
+	while(true){
+		slot = &slots[position & mask];
+		int difference = int(ofxTLLoadAcquire(&slot->sequence) - position);
+		if(difference == 0){
+			//the slot is free, claim it unless another thread just did
+			if(ofxTLCompareAndSwap(&pushPosition, position, position+1)){
+				break;
+			}
+		}
+		else if(difference < 0){
+			//the reader hasn't freed this slot since the last time around
+			ofxTLAtomicIncrement(&numOverflowed);
+			return false;
+		}
+		position = pushPosition;
+	}
+	
+	slot->event = event;
+	ofxTLStoreRelease(&slot->sequence, position+1);
+	return true;
+}
+
+bool ofxTLEventQueue::pop(ofxTLQueuedEvent& event){
+	if(slots.empty()){
+		return false;
+	}
+	unsigned int position = popPosition;
+	Slot& slot = slots[position & mask];
+	if(int(ofxTLLoadAcquire(&slot.sequence) - (position+1)) < 0){
+		return false;
+	}
+	event = slot.event;
+	popPosition = position+1;
+	//hand the slot back to the writers for their next time around
+	ofxTLStoreRelease(&slot.sequence, position + mask + 1);
+	return true;
+}
+
+void ofxTLEventQueue::clear(){
+	ofxTLQueuedEvent event;
+	while(pop(event)){
+		ofxTLAtomicIncrement(&numDropped);
+	}
+}
+
+void ofxTLEventQueue::discardTrack(ofxTLTrack* track){
+	vector<ofxTLQueuedEvent> kept;
+	ofxTLQueuedEvent event;
+	while(pop(event)){
+		ofxTLTrack* sender = event.type == ofxTLQueuedEvent::BANG ? event.bang.track : event.switched.track;
+		if(sender == track){
+			ofxTLAtomicIncrement(&numDropped);
+		}
+		else{
+			kept.push_back(event);
+		}
+	}
+	//everything came out of this queue, so it all fits back in
+	for(int i = 0; i < kept.size(); i++){
+		push(kept[i]);
+	}
+}
+
+unsigned int ofxTLEventQueue::getNumOverflowed(){
+	return numOverflowed;
+}
+
+unsigned int ofxTLEventQueue::getNumDropped(){
+	return numDropped;
+}
+
+void ofxTLEventQueue::resetCounters(){
+	numOverflowed = 0;
+	numDropped = 0;
+}
@@ -0,0 +1,93 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxTLEvents.h"
+
+//a bang or switch waiting in an ofxTLEventQueue
+class ofxTLQueuedEvent {
+  public:
+	enum Type {
+		BANG,
+		SWITCH
+	};
+	Type type;
+	//ofxTLClock::getNanos() when the event was queued
+	unsigned long long timestampNanos;
+	//only the one matching type is filled in
+	ofxTLBangEventArgs bang;
+	ofxTLSwitchEventArgs switched;
+};
+
+//Bounded queue that several threads can push into and one thread drains, without locks.
+//Every slot is allocated up front and claimed with a compare and swap on its sequence number,
+//so a push never waits on the reader. When the queue is full new events are turned away and counted.
+class ofxTLEventQueue {
+  public:
+	ofxTLEventQueue();
+	
+	//rounded up to a power of two. throws away anything queued, only call while nothing is pushing
+	void allocate(int size);
+	int getCapacity();
+	
+	//false if the queue was full
+	bool push(const ofxTLQueuedEvent& event);
+	//false if there was nothing queued, only one thread may pop at a time
+	bool pop(ofxTLQueuedEvent& event);
+	
+	//empties the queue, the events are counted as dropped
+	void clear();
+	//drops the events sent by one track and keeps the rest in order, for tracks that are being deleted
+	//only call from the thread that pops, while nothing is pushing
+	void discardTrack(ofxTLTrack* track);
+	
+	//events that were pushed while the queue was full
+	unsigned int getNumOverflowed();
+	//events thrown away by clear() or allocate() before being popped
+	unsigned int getNumDropped();
+	void resetCounters();
+	
+  protected:
+	class Slot {
+	  public:
+		volatile unsigned int sequence;
+		ofxTLQueuedEvent event;
+	};
+	vector<Slot> slots;
+	unsigned int mask;
+	volatile unsigned int pushPosition;
+	volatile unsigned int popPosition;
+	volatile unsigned int numOverflowed;
+	volatile unsigned int numDropped;
+};
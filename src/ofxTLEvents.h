@@ -69,6 +69,9 @@ class ofxTLBangEventArgs : public ofEventArgs {
 	float currentTime;
 	int currentFrame;
     long currentMillis;
+	//the bang's key time, and how far behind it the event was sent
+	unsigned long long scheduledMillis;
+	float latenessMillis;
 	string flag;
 };
 
@@ -78,6 +81,15 @@ class ofxTLSwitchEventArgs : public ofEventArgs {
     ofxTLTrack* track;
 	string switchName;
 	bool on;
+	long currentMillis; //the playhead when the switch was crossed
+	unsigned long long switchMillis; //the start or end of the switch, whichever was crossed
+};
+
+class ofxTLLoadEventArgs : public ofEventArgs {
+  public:
+    ofxTimeline* sender;
+	int tracksLoaded;
+	int totalTracks;
 };
 
 class ofxTLEvents {
@@ -96,6 +108,9 @@ class ofxTLEvents {
 	ofEvent<ofxTLSwitchEventArgs> switched;
 	
 	ofEvent<ofxTLPageEventArgs> pageChanged;
+	
+	//sent from loadTracksFromFolder as the tracks finish loading, always on the main thread
+	ofEvent<ofxTLLoadEventArgs> loadProgress;
 		
 	ofEvent<ofEventArgs> viewWasResized;
 
@@ -183,7 +183,7 @@ void ofxTLFlags::keyPressed(ofKeyEventArgs& args){
 }
 
 ofxTLKeyframe* ofxTLFlags::newKeyframe(){
-	ofxTLFlag* key = new ofxTLFlag();
+	ofxTLFlag* key = createKeyframe<ofxTLFlag>();
 	key->textField.setFont(timeline->getFont());
 	return key;
 }
@@ -200,11 +200,26 @@ void ofxTLFlags::restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore){
     triggerKey->textField.text = xmlStore.getValue("flag", "");
 }
 
+void ofxTLFlags::restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues){
+    ofxTLFlag* triggerKey = (ofxTLFlag*)key;
+    triggerKey->textField.text = keyValues.getValue("flag", "");
+}
+
 void ofxTLFlags::storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore){
     ofxTLFlag* triggerKey = (ofxTLFlag*)key;
     xmlStore.addValue("flag", triggerKey->textField.text);
 }
 
+void ofxTLFlags::restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader){
+    ofxTLFlag* triggerKey = (ofxTLFlag*)key;
+    triggerKey->textField.text = reader.readString();
+}
+
+void ofxTLFlags::storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer){
+    ofxTLFlag* triggerKey = (ofxTLFlag*)key;
+    writer.writeString(triggerKey->textField.text);
+}
+
 void ofxTLFlags::willDeleteKeyframe(ofxTLKeyframe* keyframe){
 	ofxTLFlag* flag = (ofxTLFlag*)keyframe;
 	if(flag->textField.getIsEditing()){
@@ -214,18 +229,9 @@ void ofxTLFlags::willDeleteKeyframe(ofxTLKeyframe* keyframe){
 	flag->textField.disable();
 }
 
-void ofxTLFlags::bangFired(ofxTLKeyframe* key){
-    ofxTLBangEventArgs args;
-    args.sender = timeline;
-    args.track = this;
-	//play solo change
-//    args.currentMillis = timeline->getCurrentTimeMillis();
-	args.currentMillis = currentTrackTime();
-    args.currentPercent = timeline->getPercentComplete();
-    args.currentFrame = timeline->getCurrentFrame();
-    args.currentTime = timeline->getCurrentTime();    
+void ofxTLFlags::createBangEvent(ofxTLKeyframe* key, ofxTLBangEventArgs& args){
+	ofxTLBangs::createBangEvent(key, args);
     args.flag = ((ofxTLFlag*)key)->textField.text;
-    ofNotifyEvent(events().bangFired, args);    
 }
 
 string ofxTLFlags::getTrackType(){
@@ -56,6 +56,9 @@ class ofxTLFlags : public ofxTLBangs {
 	virtual void unselectAll();
     
     virtual string getTrackType();
+    virtual bool supportsUndoDeltas(){ return false; }
+    //new flags size their text field with the timeline's font, which may upload it to GL
+    virtual bool canLoadOnThread(){ return false; }
 	
 	virtual void addFlag(string key);
 	virtual void addFlagAtTime(string key, unsigned long long time);
@@ -64,8 +67,11 @@ protected:
     
     virtual ofxTLKeyframe* newKeyframe();
     virtual void restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore);
+	virtual void restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues);
 	virtual void storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore);
-    virtual void bangFired(ofxTLKeyframe* key);
+	virtual void restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader);
+	virtual void storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer);
+    virtual void createBangEvent(ofxTLKeyframe* key, ofxTLBangEventArgs& args);
 	virtual void willDeleteKeyframe(ofxTLKeyframe* keyframe);
 
 	//only set per mousedown/mouseup cycle
@@ -0,0 +1,193 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "ofxTLKeyframePool.h"
+
+#define MIN_SLOTS_PER_CHUNK 32
+#define MAX_SLOTS_PER_CHUNK 4096
+
+ofxTLKeyframePool::ofxTLKeyframePool()
+:	numAllocations(0),
+	numRecycled(0),
+	numLive(0),
+	numHeapAllocations(0),
+	reservedBytes(0)
+{
+	//
+}
+
+ofxTLKeyframePool::~ofxTLKeyframePool(){
+	if(numLive != 0){
+		ofLogWarning("ofxTLKeyframePool::~ofxTLKeyframePool") << numLive << " keyframes are still in use";
+	}
+	map<char*, Chunk>::iterator it;
+	for(it = chunks.begin(); it != chunks.end(); it++){
+		free(it->second.memory);
+	}
+}
+
+void* ofxTLKeyframePool::allocate(size_t bytes){
+	//keep every slot 16 byte aligned
+	size_t slotSize = (bytes + 15) & ~size_t(15);
+	SlotList& slotList = slotLists[slotSize];
+	
+	numAllocations++;
+	numLive++;
+	
+	if(!slotList.freeSlots.empty()){
+		void* slot = slotList.freeSlots.back();
+		slotList.freeSlots.pop_back();
+		numRecycled++;
+		return slot;
+	}
+	
+	//carve the next slot from the current chunk, moving to the next one when it's full
+	while(slotList.currentChunk < slotList.chunks.size() &&
+		  slotList.chunks[slotList.currentChunk]->numUsed == slotList.chunks[slotList.currentChunk]->numSlots)
+	{
+		slotList.currentChunk++;
+	}
+	Chunk* chunk;
+	if(slotList.currentChunk < slotList.chunks.size()){
+		chunk = slotList.chunks[slotList.currentChunk];
+	}
+	else{
+		chunk = addChunk(slotSize, slotList);
+	}
+	return chunk->memory + slotSize * chunk->numUsed++;
+}
+
+void ofxTLKeyframePool::release(void* slot){
+	Chunk* chunk = findChunk(slot);
+	if(chunk == NULL){
+		ofLogError("ofxTLKeyframePool::release") << "slot wasn't allocated by this pool";
+		return;
+	}
+	slotLists[chunk->slotSize].freeSlots.push_back(slot);
+	numLive--;
+}
+
+bool ofxTLKeyframePool::owns(void* slot) const{
+	return findChunk(slot) != NULL;
+}
+
+void ofxTLKeyframePool::reset(){
+	if(numLive != 0){
+		ofLogError("ofxTLKeyframePool::reset") << "can't reset with " << numLive << " keyframes in use";
+		return;
+	}
+	map<size_t, SlotList>::iterator it;
+	for(it = slotLists.begin(); it != slotLists.end(); it++){
+		SlotList& slotList = it->second;
+		for(int i = 0; i < slotList.chunks.size(); i++){
+			slotList.chunks[i]->numUsed = 0;
+		}
+		slotList.currentChunk = 0;
+		slotList.freeSlots.clear();
+	}
+}
+
+void ofxTLKeyframePool::releaseMemory(){
+	if(numLive != 0){
+		ofLogError("ofxTLKeyframePool::releaseMemory") << "can't release memory with " << numLive << " keyframes in use";
+		return;
+	}
+	map<char*, Chunk>::iterator it;
+	for(it = chunks.begin(); it != chunks.end(); it++){
+		free(it->second.memory);
+	}
+	chunks.clear();
+	slotLists.clear();
+	reservedBytes = 0;
+}
+
+ofxTLKeyframePool::Chunk* ofxTLKeyframePool::findChunk(void* slot) const{
+	if(chunks.empty()){
+		return NULL;
+	}
+	//the owning chunk is the last one starting at or before the slot
+	map<char*, Chunk>::const_iterator it = chunks.upper_bound((char*)slot);
+	if(it == chunks.begin()){
+		return NULL;
+	}
+	--it;
+	const Chunk& chunk = it->second;
+	if((char*)slot >= chunk.memory + chunk.slotSize * chunk.numSlots){
+		return NULL;
+	}
+	return const_cast<Chunk*>(&chunk);
+}
+
+ofxTLKeyframePool::Chunk* ofxTLKeyframePool::addChunk(size_t slotSize, SlotList& slotList){
+	//grow with the track so big tracks don't need thousands of chunks
+	int numSlots = ofClamp(slotList.numReserved, MIN_SLOTS_PER_CHUNK, MAX_SLOTS_PER_CHUNK);
+	
+	Chunk chunk;
+	chunk.memory = (char*)malloc(slotSize * numSlots);
+	chunk.slotSize = slotSize;
+	chunk.numSlots = numSlots;
+	chunk.numUsed = 0;
+	
+	Chunk* addedChunk = &(chunks[chunk.memory] = chunk);
+	slotList.chunks.push_back(addedChunk);
+	slotList.currentChunk = slotList.chunks.size()-1;
+	slotList.numReserved += numSlots;
+	
+	numHeapAllocations++;
+	reservedBytes += slotSize * numSlots;
+	return addedChunk;
+}
+
+unsigned long long ofxTLKeyframePool::getNumAllocations() const{
+	return numAllocations;
+}
+
+unsigned long long ofxTLKeyframePool::getNumRecycled() const{
+	return numRecycled;
+}
+
+unsigned long long ofxTLKeyframePool::getNumLive() const{
+	return numLive;
+}
+
+unsigned long long ofxTLKeyframePool::getNumHeapAllocations() const{
+	return numHeapAllocations;
+}
+
+int ofxTLKeyframePool::getNumChunks() const{
+	return chunks.size();
+}
+
+size_t ofxTLKeyframePool::getReservedBytes() const{
+	return reservedBytes;
+}
@@ -0,0 +1,94 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#pragma once
+
+#include "ofMain.h"
+
+//Hands out memory for keyframes from large chunks instead of one heap allocation per key.
+//Released slots are kept on a free list per slot size and recycled by the next allocation,
+//and once every key is gone reset() makes all of the chunks available again at once.
+class ofxTLKeyframePool {
+  public:
+	ofxTLKeyframePool();
+	~ofxTLKeyframePool();
+	
+	void* allocate(size_t bytes);
+	void release(void* slot);
+	bool owns(void* slot) const;
+	
+	//forget every slot in one go, only valid when none are in use
+	void reset();
+	//give the chunks back to the heap, only valid when none are in use
+	void releaseMemory();
+	
+	//counters for checking the pool is doing its job
+	unsigned long long getNumAllocations() const; //total slots handed out
+	unsigned long long getNumRecycled() const; //allocations served from released slots
+	unsigned long long getNumLive() const; //slots currently in use
+	unsigned long long getNumHeapAllocations() const; //chunks ever requested from the heap
+	int getNumChunks() const;
+	size_t getReservedBytes() const;
+	
+  protected:
+	struct Chunk {
+		char* memory;
+		size_t slotSize;
+		int numSlots;
+		int numUsed; //slots carved from the front of the chunk so far
+	};
+	struct SlotList {
+		SlotList() : currentChunk(0), numReserved(0) {}
+		vector<Chunk*> chunks;
+		int currentChunk;
+		int numReserved;
+		vector<void*> freeSlots;
+	};
+	
+	Chunk* findChunk(void* slot) const;
+	Chunk* addChunk(size_t slotSize, SlotList& slotList);
+	
+	map<char*, Chunk> chunks; //keyed by start address to find the chunk owning a slot
+	map<size_t, SlotList> slotLists;
+	
+	unsigned long long numAllocations;
+	unsigned long long numRecycled;
+	unsigned long long numLive;
+	unsigned long long numHeapAllocations;
+	size_t reservedBytes;
+	
+  private:
+	//the pool owns raw memory and can't be copied
+	ofxTLKeyframePool(const ofxTLKeyframePool& other);
+	ofxTLKeyframePool& operator=(const ofxTLKeyframePool& other);
+};
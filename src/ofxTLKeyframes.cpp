@@ -34,26 +34,69 @@
 #include "ofxTimeline.h"
 #include "ofxHotKeys.h"
 
+//an emptied track keeps this much of its keyframe pool for the keys it gets next and frees the rest
+static const size_t maxRetainedPoolBytes = 256 * 1024;
+
 bool keyframesort(ofxTLKeyframe* a, ofxTLKeyframe* b){
 	return a->time < b->time;
 }
 
+bool keyframeIsBeforeTime(ofxTLKeyframe* key, unsigned long long sampleTime){
+	return key->time < sampleTime;
+}
+
+//sorts through a contiguous copy of the times instead of dereferencing two keys per comparison
+//keys with the same time keep their order
+void sortKeyframesByTime(vector<ofxTLKeyframe*>& keys){
+	bool keysAreSorted = true;
+	for(int i = 1; i < keys.size(); i++){
+		if(keys[i]->time < keys[i-1]->time){
+			keysAreSorted = false;
+			break;
+		}
+	}
+	//most edits leave the keys in order
+	if(keysAreSorted){
+		return;
+	}
+	
+	vector< pair<unsigned long long, int> > order(keys.size());
+	for(int i = 0; i < keys.size(); i++){
+		order[i] = make_pair(keys[i]->time, i);
+	}
+	sort(order.begin(), order.end());
+	vector<ofxTLKeyframe*> sortedKeys(keys.size());
+	for(int i = 0; i < order.size(); i++){
+		sortedKeys[i] = keys[order[i].second];
+	}
+	keys.swap(sortedKeys);
+}
+
 ofxTLKeyframes::ofxTLKeyframes()
 :	hoverKeyframe(NULL),
 	keysAreDraggable(false),
 	keysDidDrag(false),
 	keysDidNudge(false),
-	lastKeyframeIndex(1),
-	lastSampleTime(0),
 	shouldRecomputePreviews(false),
 	createNewOnMouseup(false),
 	useBinarySave(false),
+	useMappedLoading(true),
+	loadedOnThread(false),
+	loadingOnThread(false),
+	keyColumnsValid(false),
+	mappedTimes(NULL),
+	mappedValues(NULL),
+	numMappedKeys(0),
+	recordingDelta(NULL),
+	undoGeneration(0),
 	valueRange(ofRange(0,1.))
 {
 	xmlFileName = "_keyframes.xml";	
 }
 
 ofxTLKeyframes::~ofxTLKeyframes(){
+	delete recordingDelta;
+	recordingDelta = NULL;
 	clear();
 }
 
@@ -67,8 +110,18 @@ void ofxTLKeyframes::recomputePreviews(){
 //		preview.addVertex(ofPoint(bounds.x+bounds.width, bounds.y + bounds.height - sampleAtPercent(.5f)*bounds.height));
 //	}
 //	else{
-		for(int p = bounds.getMinX(); p <= bounds.getMaxX(); p+=2){
-			preview.addVertex(p,  bounds.y + bounds.height - sampleAtPercent(screenXtoNormalizedX(p)) * bounds.height);
+		//one sample every two pixels
+		int firstX = bounds.getMinX();
+		int numSamples = (bounds.getMaxX() - firstX) / 2 + 1;
+		if(numSamples > 0){
+			vector<float> samples(numSamples);
+			double duration = timeline->getDurationInMilliseconds();
+			sampleRange(screenXtoNormalizedX(firstX) * duration,
+						screenXtoNormalizedX(firstX + (numSamples-1)*2) * duration,
+						numSamples, &samples[0]);
+			for(int i = 0; i < numSamples; i++){
+				preview.addVertex(firstX + i*2, bounds.y + bounds.height - samples[i] * bounds.height);
+			}
 		}
 //	}
 //	int size = preview.getVertices().size();
@@ -88,6 +141,19 @@ void ofxTLKeyframes::recomputePreviews(){
 		
 		lastPoint = screenpoint;
 	}
+	//only visit the mapped keys in view so zooming in on a huge track doesn't page in all of it
+	if(isMapped()){
+		double duration = timeline->getDurationInMilliseconds();
+		int firstVisible = lower_bound(mappedTimes, mappedTimes+numMappedKeys, (unsigned long long)(zoomBounds.min*duration)) - mappedTimes;
+		int endVisible = upper_bound(mappedTimes, mappedTimes+numMappedKeys, (unsigned long long)(zoomBounds.max*duration)) - mappedTimes;
+		for(int i = firstVisible; i < endVisible; i++){
+			ofVec2f screenpoint(millisToScreenX(mappedTimes[i]), valueToScreenY(mappedValues[i]));
+			if(lastPoint.squareDistance(screenpoint) > 5*5){
+				keyPoints.push_back(screenpoint);
+			}
+			lastPoint = screenpoint;
+		}
+	}
 	
 	shouldRecomputePreviews = false;
 	
@@ -175,9 +241,11 @@ void ofxTLKeyframes::setDefaultValue(float newDefaultValue){
 }
 
 void ofxTLKeyframes::quantizeKeys(int step){
+	materializeKeyframes();
 	for(int i = 0; i < keyframes.size(); i++){
 		setKeyframeTime(keyframes[i], getTimeline()->getQuantizedTime(keyframes[i]->time, step));
 	}
+	updateKeyframeSort();
 }
 
 ofRange ofxTLKeyframes::getValueRange(){
@@ -198,13 +266,50 @@ float ofxTLKeyframes::getValueAtTimeInMillis(long sampleTime){
 	return ofMap(sampleAtTime(sampleTime), 0.0, 1.0, valueRange.min, valueRange.max, false);
 }
 
+float ofxTLKeyframes::getValueAtPercent(float percent, ofxTLKeyframeCursor* cursor) const{
+    return getValueAtTimeInMillis(percent*timeline->getDurationInMilliseconds(), cursor);
+}
+
+float ofxTLKeyframes::getValueAtTimeInMillis(long sampleTime, ofxTLKeyframeCursor* cursor) const{
+	return ofMap(sampleAtTime(sampleTime, cursor), 0.0, 1.0, valueRange.min, valueRange.max, false);
+}
+
+void ofxTLKeyframes::getValuesInRange(unsigned long long startMillis, unsigned long long endMillis, int count, float* values) const{
+	sampleRange(startMillis, endMillis, count, values);
+	for(int i = 0; i < count; i++){
+		values[i] = valueRange.min + values[i] * valueRange.span();
+	}
+}
+
+void ofxTLKeyframes::getValuesAtRate(double startMillis, double sampleRate, int count, float* values) const{
+	sampleRange(startMillis, startMillis + (count-1)*1000.0/sampleRate, count, values);
+	for(int i = 0; i < count; i++){
+		values[i] = valueRange.min + values[i] * valueRange.span();
+	}
+}
+
 float ofxTLKeyframes::sampleAtPercent(float percent){
 	return sampleAtTime(percent * timeline->getDurationInMilliseconds());
 }
 
 float ofxTLKeyframes::sampleAtTime(long sampleTime){
+	return sampleAtTime(sampleTime, &playbackCursor);
+}
+
+float ofxTLKeyframes::sampleAtTime(long sampleTime, ofxTLKeyframeCursor* cursor) const{
 	sampleTime = ofClamp(sampleTime, 0, timeline->getDurationInMilliseconds());
 	
+	if(isMapped()){
+		if(sampleTime <= mappedTimes[0]){
+			return mappedValues[0];
+		}
+		if(sampleTime >= mappedTimes[numMappedKeys-1]){
+			return mappedValues[numMappedKeys-1];
+		}
+		int i = keyframeIndexForTime(sampleTime, cursor);
+		return interpolateMappedKeys(i-1, i, sampleTime);
+	}
+	
 	//edge cases
 	if(keyframes.size() == 0){
 		return ofMap(defaultValue, valueRange.min, valueRange.max, 0, 1.0, true);
@@ -218,50 +323,199 @@ float ofxTLKeyframes::sampleAtTime(long sampleTime){
 		return evaluateKeyframeAtTime(keyframes[keyframes.size()-1], sampleTime);
 	}
 	
-	//optimization for linear playback
-	int startKeyframeIndex = 1;
-	if(sampleTime >= lastSampleTime){
-		startKeyframeIndex = lastKeyframeIndex;
+	int i = keyframeIndexForTime(sampleTime, cursor);
+	return interpolateKeysAtIndices(i-1, i, sampleTime);
+}
+
+//returns the index of the first keyframe at or after sampleTime
+//sampleTime must be after the first keyframe and no later than the last
+int ofxTLKeyframes::keyframeIndexForTime(unsigned long long sampleTime, ofxTLKeyframeCursor* cursor) const{
+	int i = -1;
+	const unsigned long long* times = NULL;
+	int numTimes = 0;
+	if(isMapped()){
+		times = mappedTimes;
+		numTimes = numMappedKeys;
+	}
+	else if(hasKeyColumns() && !keyTimes.empty()){
+		times = &keyTimes[0];
+		numTimes = keyTimes.size();
 	}
 	
-	for(int i = startKeyframeIndex; i < keyframes.size(); i++){
-		if(keyframes[i]->time >= sampleTime){
-			lastKeyframeIndex = i;
-			lastSampleTime = sampleTime;
-			return interpolateValueForKeys(keyframes[i-1], keyframes[i], sampleTime);
+	//search the time column unless a subclass changed the keyframes without updating it
+	if(times == NULL){
+		i = lower_bound(keyframes.begin()+1, keyframes.end(), sampleTime, keyframeIsBeforeTime) - keyframes.begin();
+	}
+	//optimization for linear playback, the key we want is almost always the last one found or just after it
+	//a stale cursor is harmless since the key before it is checked first
+	else if(cursor != NULL){
+		int hintKeyframeIndex = cursor->keyframeIndex;
+		if(hintKeyframeIndex > 0 && hintKeyframeIndex < numTimes &&
+		   times[hintKeyframeIndex-1] < sampleTime)
+		{
+			int searchEnd = MIN(hintKeyframeIndex + 8, numTimes);
+			for(int k = hintKeyframeIndex; k < searchEnd; k++){
+				if(times[k] >= sampleTime){
+					i = k;
+					break;
+				}
+			}
 		}
 	}
-	ofLog(OF_LOG_ERROR, "ofxTLKeyframes --- Error condition, couldn't find keyframe for percent " + ofToString(sampleTime));
-	return defaultValue;
+	//scrubbing and random access fall back to a binary search
+	if(i == -1){
+		i = lower_bound(times+1, times+numTimes, sampleTime) - times;
+	}
+	if(cursor != NULL){
+		cursor->keyframeIndex = i;
+	}
+	return i;
+}
+
+void ofxTLKeyframes::sampleRange(double startMillis, double endMillis, int count, float* samples) const{
+	if(count <= 0){
+		return;
+	}
+	
+	double sampleStep = count > 1 ? (endMillis - startMillis) / (count - 1) : 0;
+	double duration = timeline->getDurationInMilliseconds();
+	
+	//mapped keys have no keyframes to hand to interpolateValuesForKeys, the cursor still makes this a walk
+	if(isMapped()){
+		ofxTLKeyframeCursor cursor;
+		for(int i = 0; i < count; i++){
+			samples[i] = sampleAtTime(startMillis + sampleStep*i, &cursor);
+		}
+		return;
+	}
+	
+	if(keyframes.size() == 0){
+		float value = ofMap(defaultValue, valueRange.min, valueRange.max, 0, 1.0, true);
+		for(int i = 0; i < count; i++){
+			samples[i] = value;
+		}
+		return;
+	}
+	
+	//backwards ranges are rare enough to just sample one at a time
+	if(sampleStep < 0){
+		ofxTLKeyframeCursor cursor;
+		for(int i = 0; i < count; i++){
+			samples[i] = sampleAtTime(startMillis + sampleStep*i, &cursor);
+		}
+		return;
+	}
+	
+	ofxTLKeyframe* firstKey = keyframes[0];
+	ofxTLKeyframe* lastKey = keyframes[keyframes.size()-1];
+	
+	int s = 0;
+	double sampleTime = MIN(MAX(startMillis, 0.0), duration);
+	while(s < count && sampleTime <= firstKey->time){
+		samples[s] = evaluateKeyframeAtTime(firstKey, sampleTime, true);
+		sampleTime = MIN(MAX(startMillis + sampleStep*(++s), 0.0), duration);
+	}
+	
+	//hand each run of samples that falls between two keys to the subclass in one call
+	ofxTLKeyframeCursor cursor;
+	while(s < count && sampleTime < lastKey->time){
+		//keys are on whole millis so the first key after a fractional time is the first one after its ceiling
+		int i = keyframeIndexForTime(ceil(sampleTime), &cursor);
+		ofxTLKeyframe* endKey = keyframes[i];
+		int runStart = s;
+		do {
+			sampleTime = startMillis + sampleStep*(++s);
+		} while(s < count && sampleTime <= endKey->time && sampleTime < lastKey->time);
+		interpolateValuesForKeys(keyframes[i-1], endKey, startMillis + sampleStep*runStart, sampleStep, s - runStart, samples + runStart);
+	}
+	
+	//the rest inside the timeline in one call too, past the end they all sample the end
+	int tailStart = s;
+	while(s < count && startMillis + sampleStep*s <= duration){
+		s++;
+	}
+	if(s > tailStart){
+		evaluateValuesForKey(lastKey, startMillis + sampleStep*tailStart, sampleStep, s - tailStart, samples + tailStart);
+	}
+	while(s < count){
+		samples[s] = evaluateKeyframeAtTime(lastKey, duration);
+		s++;
+	}
+}
+
+void ofxTLKeyframes::interpolateValuesForKeys(ofxTLKeyframe* start, ofxTLKeyframe* end, double firstSampleTime, double sampleStep, int count, float* samples) const{
+	for(int i = 0; i < count; i++){
+		samples[i] = interpolateValueForKeys(start, end, firstSampleTime + sampleStep*i);
+	}
+}
+
+void ofxTLKeyframes::evaluateValuesForKey(ofxTLKeyframe* key, double firstSampleTime, double sampleStep, int count, float* samples) const{
+	for(int i = 0; i < count; i++){
+		samples[i] = evaluateKeyframeAtTime(key, firstSampleTime + sampleStep*i);
+	}
 }
 
-float ofxTLKeyframes::evaluateKeyframeAtTime(ofxTLKeyframe* key, unsigned long long sampleTime, bool firstKey){
+float ofxTLKeyframes::evaluateKeyframeAtTime(ofxTLKeyframe* key, unsigned long long sampleTime, bool firstKey) const{
 	return key->value;
 }
 
-float ofxTLKeyframes::interpolateValueForKeys(ofxTLKeyframe* start,ofxTLKeyframe* end, unsigned long long sampleTime){
+float ofxTLKeyframes::interpolateValueForKeys(ofxTLKeyframe* start,ofxTLKeyframe* end, unsigned long long sampleTime) const{
 	return ofMap(sampleTime, start->time, end->time, start->value, end->value);
 }
 
+float ofxTLKeyframes::interpolateKeysAtIndices(int startIndex, int endIndex, unsigned long long sampleTime) const{
+	return interpolateValueForKeys(keyframes[startIndex], keyframes[endIndex], sampleTime);
+}
+
+float ofxTLKeyframes::interpolateMappedKeys(int startIndex, int endIndex, unsigned long long sampleTime) const{
+	return ofMap(sampleTime, mappedTimes[startIndex], mappedTimes[endIndex], mappedValues[startIndex], mappedValues[endIndex]);
+}
+
 void ofxTLKeyframes::load(){
-    clear();
-	if(useBinarySave){
-		loadFromBinaryFile();
+	if(loadKeyframeFiles()){
+		timeline->flagTrackModified(this);
 	}
-	else{
-		ofxXmlSettings savedkeyframes;
-		if(!savedkeyframes.loadFile(xmlFileName)){
+}
+
+bool ofxTLKeyframes::canLoadOnThread(){
+	return false;
+}
+
+void ofxTLKeyframes::loadOnThread(){
+	loadingOnThread = true;
+	loadedOnThread = loadKeyframeFiles();
+	loadingOnThread = false;
+}
+
+void ofxTLKeyframes::finishLoad(){
+	if(loadedOnThread){
+		//updateKeyframeSort leaves the duration alone on the worker
+		fitDurationToKeyframes();
+		timeline->flagTrackModified(this);
+	}
+	loadedOnThread = false;
+}
+
+bool ofxTLKeyframes::loadKeyframeFiles(){
+    clear();
+	//fall back to the xml when there's no binary file yet so existing projects can switch over
+	if(!useBinarySave || !loadFromBinaryFile()){
+		//read the keys straight out of the file's pages instead of loading it into a document
+		ofxTLMappedFile savedkeyframes;
+		if(!ofFile::doesFileExist(xmlFileName) || !savedkeyframes.open(xmlFileName)){
 			ofLog(OF_LOG_NOTICE, "ofxTLKeyframes --- couldn't load xml file " + xmlFileName);
-			return;
+			return false;
 		}
 		
-		createKeyframesFromXML(savedkeyframes, keyframes);
+		if(!createKeyframesFromXMLText(savedkeyframes.getData(), savedkeyframes.size(), keyframes)){
+			ofLogError("ofxTLKeyframes::load") << "couldn't read keyframes from " << xmlFileName;
+		}
 	}
 	updateKeyframeSort();
-	timeline->flagTrackModified(this);
+	return true;
 }
 
-void ofxTLKeyframes::createKeyframesFromXML(ofxXmlSettings xmlStore, vector<ofxTLKeyframe*>& keyContainer){
+void ofxTLKeyframes::createKeyframesFromXML(ofxXmlSettings& xmlStore, vector<ofxTLKeyframe*>& keyContainer){
 
 	int numKeyframeStores = xmlStore.getNumTags("keyframes");
 	for(int store = 0; store < numKeyframeStores; store++){
@@ -301,21 +555,101 @@ void ofxTLKeyframes::createKeyframesFromXML(ofxXmlSettings xmlStore, vector<ofxT
 		
 		xmlStore.popTag(); //keyframes
 	}
-	sort(keyContainer.begin(), keyContainer.end(), keyframesort);
+	sortKeyframesByTime(keyContainer);
+}
+
+bool ofxTLKeyframes::createKeyframesFromXMLText(const char* data, size_t length, vector<ofxTLKeyframe*>& keyContainer){
+	
+	int firstNewKey = keyContainer.size();
+	ofxTLXmlKeyReader keyValues(data, length);
+	while(keyValues.nextKey()){
+		ofxTLKeyframe* key = newKeyframe();
+		
+		string legacyX = keyValues.getValue("x", "");
+		//if there is a decimal this is most likely an old save so let's
+		//convert it based on the current duration
+		if(legacyX != ""){
+			ofLogNotice() << "ofxTLKeyframes::createKeyframesFromXMLText -- Found legacy time " + legacyX << endl;
+			float normalizedTime = ofToFloat(legacyX);
+			key->time = key->previousTime =  normalizedTime*timeline->getDurationInMilliseconds();
+		}
+		else {
+			string timecode = keyValues.getValue("time", "00:00:00:000");
+			key->time = key->previousTime = timeline->getTimecode().millisForTimecode(timecode);
+		}
+		
+		float legacyYValue = keyValues.getValue("y", 0.0);
+		if(legacyYValue != 0.0){
+			ofLogNotice() << "ofxTLKeyframes::createKeyframesFromXMLText -- Found legacy value " << legacyYValue << endl;
+			key->value = legacyYValue;
+		}
+		else{
+			key->value = keyValues.getValue("value", 0.0);
+		}
+		restoreKeyframeFromXMLValues(key, keyValues);
+		keyContainer.push_back(key);
+	}
+	
+	//like ofxXmlSettings, load nothing from broken xml
+	if(!keyValues.good()){
+		for(int i = firstNewKey; i < keyContainer.size(); i++){
+			destroyKeyframe(keyContainer[i]);
+		}
+		keyContainer.resize(firstNewKey);
+		return false;
+	}
+	
+	sortKeyframesByTime(keyContainer);
+	return true;
+}
+
+void ofxTLKeyframes::restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues){
+	ofxXmlSettings xmlStore;
+	for(int i = 0; i < keyValues.getNumValues(); i++){
+		xmlStore.addValue(keyValues.getTagName(i), keyValues.getTagText(i));
+	}
+	restoreKeyframe(key, xmlStore);
 }
 
 void ofxTLKeyframes::clear(){
 
+	//the keys an edit in progress recorded are about to go away, start the recording over
+	bool wasRecording = recordingDelta != NULL;
+	delete recordingDelta;
+	recordingDelta = NULL;
+	
 	for(int i = 0; i < keyframes.size(); i++){
 		willDeleteKeyframe(keyframes[i]);
-		delete keyframes[i];
+		destroyKeyframe(keyframes[i]);
 	}
 	keyframes.clear();
     selectedKeyframes.clear();
+	unmapKeyframes();
+	undoGeneration++;
+	if(wasRecording){
+		recordingDelta = new ofxTLKeyframesUndoDelta(this, undoGeneration);
+	}
+	//with every key gone the pool can hand out its memory from the start again,
+	//or give it back if the track was big enough that holding on to its peak would waste it
+	if(keyframePool.getNumLive() == 0){
+		if(keyframePool.getReservedBytes() > maxRetainedPoolBytes){
+			keyframePool.releaseMemory();
+		}
+		else{
+			keyframePool.reset();
+		}
+	}
 	updateKeyframeSort();
 }
 
 void ofxTLKeyframes::save(){
+	//the mapped file is the saved state until the track is edited
+	if(isMapped()){
+		if(useBinarySave && mappedFile.getPath() == getBinaryFileName()){
+			return;
+		}
+		materializeKeyframes();
+	}
 	if(useBinarySave){
 		saveToBinaryFile();
 	}
@@ -353,6 +687,7 @@ string ofxTLKeyframes::getXMLStringForKeyframes(vector<ofxTLKeyframe*>& keys){
 
 bool ofxTLKeyframes::mousePressed(ofMouseEventArgs& args, long millis){
 	
+	materializeKeyframes();
 	ofVec2f screenpoint = ofVec2f(args.x, args.y);
 	keysAreStretchable = ofGetModifierShiftPressed() && ofGetModifierControlPressed();
     keysDidDrag = false;
@@ -428,8 +763,14 @@ bool ofxTLKeyframes::mousePressed(ofMouseEventArgs& args, long millis){
 }
 
 void ofxTLKeyframes::regionSelected(ofLongRange timeRange, ofRange valueRange){
-    for(int i = 0; i < keyframes.size(); i++){
-        if(timeRange.contains(keyframes[i]->time) && valueRange.contains(1.-keyframes[i]->value)){
+	materializeKeyframes();
+	if(!hasKeyColumns()){
+		updateKeyframeColumns();
+	}
+	//only visit the keys inside the time range
+	int firstKey = lower_bound(keyTimes.begin(), keyTimes.end(), timeRange.min) - keyTimes.begin();
+	for(int i = firstKey; i < keyTimes.size() && keyTimes[i] <= timeRange.max; i++){
+        if(valueRange.contains(1.-keyValues[i])){
             selectKeyframe(keyframes[i]);
         }
 	}
@@ -493,47 +834,72 @@ void ofxTLKeyframes::mouseDragged(ofMouseEventArgs& args, long millis){
 void ofxTLKeyframes::updateKeyframeSort(){
 	//reset these caches because they may no longer be valid
 	shouldRecomputePreviews = true;
-	lastKeyframeIndex = 1;
-	lastSampleTime = 0;
+	playbackCursor.reset();
 	if(keyframes.size() > 1){
-		//modify duration to fit
-		for(int i = 0; i < keyframes.size(); i++){
-			if(keyframes[i]->time > timeline->getDurationInMilliseconds()){
-				//keyframes[i]->time = timeline->getDurationInMilliseconds();
-				timeline->setDurationInMillis(keyframes[i]->time);
-			}
-		}
+		sortKeyframesByTime(keyframes);
 		
-		sort(keyframes.begin(), keyframes.end(), keyframesort);
+		//modify duration to fit, but only from the main thread
+		if(!loadingOnThread){
+			fitDurationToKeyframes();
+		}
 		
 		for(int i = 0; i < keyframes.size()-1; i++){
 			if(keyframes[i]->time == keyframes[i+1]->time){
 				if(keyframes[i]->previousTime < keyframes[i+1]->time){
+					keyframeWillChange(keyframes[i]);
 					keyframes[i]->time -= 1;
 				}
 				else{
+					keyframeWillChange(keyframes[i+1]);
 					keyframes[i+1]->time+=1;
 				}
 			}
 		}
 		if(selectedKeyframes.size() > 1){
-			sort(selectedKeyframes.begin(), selectedKeyframes.end(), keyframesort);
+			sortKeyframesByTime(selectedKeyframes);
 		}
 	}
+	updateKeyframeColumns();
+}
+
+void ofxTLKeyframes::fitDurationToKeyframes(){
+	if(keyframes.size() > 1 && keyframes[keyframes.size()-1]->time > timeline->getDurationInMilliseconds()){
+		timeline->setDurationInMillis(keyframes[keyframes.size()-1]->time);
+	}
+}
+
+void ofxTLKeyframes::updateKeyframeColumns(){
+	keyTimes.resize(keyframes.size());
+	keyValues.resize(keyframes.size());
+	for(int i = 0; i < keyframes.size(); i++){
+		keyTimes[i] = keyframes[i]->time;
+		keyValues[i] = keyframes[i]->value;
+	}
+	keyColumnsValid = true;
+}
+
+void ofxTLKeyframes::keyframeAppended(ofxTLKeyframe* key){
+	keyTimes.push_back(key->time);
+	keyValues.push_back(key->value);
+}
+
+//the size check catches subclasses that add or remove keys without going through the columns
+bool ofxTLKeyframes::hasKeyColumns() const{
+	return keyColumnsValid && keyTimes.size() == keyframes.size();
 }
 
 void ofxTLKeyframes::mouseReleased(ofMouseEventArgs& args, long millis){
 	keysAreDraggable = false;
     if(keysDidDrag){
 		//reset these caches because they may no longer be valid
-		lastKeyframeIndex = 1;
-		lastSampleTime = 0;
+		playbackCursor.reset();
         timeline->flagTrackModified(this);
     }
 	
 	if(createNewOnMouseup){
 		//add a new one
 		selectedKeyframe = newKeyframe();
+		keyframeWasAdded(selectedKeyframe);
 		setKeyframeTime(selectedKeyframe,millis);
 		selectedKeyframe->value = screenYToValue(args.y);
 		keyframes.push_back(selectedKeyframe);
@@ -545,8 +911,10 @@ void ofxTLKeyframes::mouseReleased(ofMouseEventArgs& args, long millis){
 }
 
 void ofxTLKeyframes::setKeyframeTime(ofxTLKeyframe* key, unsigned long long newTime){
+	keyframeWillChange(key);
 	key->previousTime = key->time;
 	key->time = newTime;
+	keyColumnsValid = false;
 }
 
 void ofxTLKeyframes::getSnappingPoints(set<unsigned long long>& points){
@@ -555,9 +923,20 @@ void ofxTLKeyframes::getSnappingPoints(set<unsigned long long>& points){
 			points.insert(keyframes[i]->time);
 		}
 	}
+	if(isMapped()){
+		double duration = timeline->getDurationInMilliseconds();
+		int firstVisible = lower_bound(mappedTimes, mappedTimes+numMappedKeys, (unsigned long long)(zoomBounds.min*duration)) - mappedTimes;
+		int endVisible = upper_bound(mappedTimes, mappedTimes+numMappedKeys, (unsigned long long)(zoomBounds.max*duration)) - mappedTimes;
+		points.insert(mappedTimes + firstVisible, mappedTimes + endVisible);
+	}
+}
+
+const ofxTLKeyframePool& ofxTLKeyframes::getKeyframePool() const{
+	return keyframePool;
 }
 
 vector<ofxTLKeyframe*>& ofxTLKeyframes::getKeyframes(){
+	materializeKeyframes();
     return keyframes;
 }
 
@@ -579,10 +958,9 @@ string ofxTLKeyframes::cutRequest(){
 
 void ofxTLKeyframes::pasteSent(string pasteboard){
 	vector<ofxTLKeyframe*> keyContainer;
-	ofxXmlSettings pastedKeys;
 	
-	if(pastedKeys.loadFromBuffer(pasteboard)){
-		createKeyframesFromXML(pastedKeys, keyContainer);
+	materializeKeyframes();
+	if(createKeyframesFromXMLText(pasteboard.c_str(), pasteboard.size(), keyContainer)){
 		if(keyContainer.size() != 0){
 			timeline->unselectAll();
 			int numKeyframesPasted = 0;
@@ -594,10 +972,11 @@ void ofxTLKeyframes::pasteSent(string pasteboard){
 				if(keyContainer[i]->time <= timeline->getDurationInMilliseconds()){
 					selectedKeyframes.push_back(keyContainer[i]);
 					keyframes.push_back(keyContainer[i]);
+					keyframeWasAdded(keyContainer[i]);
 					numKeyframesPasted++;
 				}
 				else{
-					delete keyContainer[i];
+					destroyKeyframe(keyContainer[i]);
 				}
 			}
 
@@ -627,20 +1006,26 @@ void ofxTLKeyframes::addKeyframeAtMillis(unsigned long long millis){
 }
 
 void ofxTLKeyframes::addKeyframeAtMillis(float value, unsigned long long millis){
+	materializeKeyframes();
 	ofxTLKeyframe* key = newKeyframe();
 	key->time = key->previousTime = millis;
 	key->value = ofMap(value, valueRange.min, valueRange.max, 0, 1.0, true);
 	keyframes.push_back(key);
+	keyframeWasAdded(key);
 	//smart sort, only sort if not added to end
-	if(keyframes.size() > 2 && keyframes[keyframes.size()-2]->time > keyframes[keyframes.size()-1]->time){
+	if(keyframes.size() > 1 && keyframes[keyframes.size()-2]->time > keyframes[keyframes.size()-1]->time){
 		updateKeyframeSort();
 	}
-	lastKeyframeIndex = 1;
+	else{
+		keyframeAppended(key);
+	}
+	playbackCursor.reset();
 	timeline->flagTrackModified(this);
 	shouldRecomputePreviews = true;
 }
 
 void ofxTLKeyframes::selectAll(){
+	materializeKeyframes();
 	selectedKeyframes = keyframes;
 }
 
@@ -653,7 +1038,10 @@ int ofxTLKeyframes::getSelectedItemCount(){
 }
 
 unsigned long long ofxTLKeyframes::getEarliestTime(){
-	if(keyframes.size() > 0){
+	if(isMapped()){
+		return mappedTimes[0];
+	}
+	else if(keyframes.size() > 0){
 		return keyframes[0]->time;
 	}
 	else{
@@ -662,7 +1050,10 @@ unsigned long long ofxTLKeyframes::getEarliestTime(){
 }
 
 unsigned long long ofxTLKeyframes::getLatestTime(){
-	if(keyframes.size() > 0){
+	if(isMapped()){
+		return mappedTimes[numMappedKeys-1];
+	}
+	else if(keyframes.size() > 0){
 		return keyframes[keyframes.size()-1]->time;
 	}
 	else{
@@ -689,61 +1080,316 @@ unsigned long long ofxTLKeyframes::getLatestSelectedTime(){
 }
 
 string ofxTLKeyframes::getXMLRepresentation(){
+	//the timeline asks for this just before an edit to keep for undo
+	materializeKeyframes();
     return getXMLStringForKeyframes(keyframes);
 }
 
 void ofxTLKeyframes::loadFromXMLRepresentation(string rep){
     clear();
-    ofxXmlSettings buffer;
-    buffer.loadFromBuffer(rep);
-    createKeyframesFromXML(buffer, keyframes);
+    createKeyframesFromXMLText(rep.c_str(), rep.size(), keyframes);
     updateKeyframeSort();
     timeline->flagUserChangedValue();    //because this is only called in Undo we don't flag track modified
 }
 
-//experimental binary saving. does not work with subclasses yet
+bool ofxTLKeyframes::supportsUndoDeltas(){
+	return true;
+}
+
+void ofxTLKeyframes::beginUndoDelta(){
+	delete recordingDelta;
+	recordingDelta = new ofxTLKeyframesUndoDelta(this, undoGeneration);
+}
+
+ofxTLUndoDelta* ofxTLKeyframes::endUndoDelta(){
+	ofxTLKeyframesUndoDelta* delta = recordingDelta;
+	recordingDelta = NULL;
+	if(delta != NULL && !delta->finish()){
+		delete delta;
+		delta = NULL;
+	}
+	return delta;
+}
+
+void ofxTLKeyframes::keyframeWillChange(ofxTLKeyframe* key){
+	if(recordingDelta != NULL){
+		recordingDelta->keyWillChange(key);
+	}
+}
+
+void ofxTLKeyframes::keyframeWasAdded(ofxTLKeyframe* key){
+	if(recordingDelta != NULL){
+		recordingDelta->keyWasAdded(key);
+	}
+}
+
+void ofxTLKeyframes::releaseKeyframe(ofxTLKeyframe* keyframe){
+	if(recordingDelta != NULL){
+		recordingDelta->keyWasRemoved(keyframe);
+	}
+	else{
+		destroyKeyframe(keyframe);
+		//undo deltas may still point at it
+		undoGeneration++;
+	}
+}
+
+void ofxTLKeyframes::exchangeKeyframes(const set<ofxTLKeyframe*>& removed, vector<ofxTLKeyframe*>& added){
+	if(removed.size() > 0){
+		int numKept = 0;
+		for(int i = 0; i < keyframes.size(); i++){
+			if(removed.find(keyframes[i]) == removed.end()){
+				keyframes[numKept++] = keyframes[i];
+			}
+		}
+		keyframes.resize(numKept);
+	}
+	if(added.size() > 0){
+		sortKeyframesByTime(added);
+		int numExisting = keyframes.size();
+		keyframes.insert(keyframes.end(), added.begin(), added.end());
+		inplace_merge(keyframes.begin(), keyframes.begin()+numExisting, keyframes.end(), keyframesort);
+	}
+	
+	//like loadFromXMLRepresentation nothing stays selected
+	selectedKeyframes.clear();
+	selectedKeyframe = NULL;
+	hoverKeyframe = NULL;
+	//already in order, so this only refreshes the columns and caches
+	updateKeyframeSort();
+	timeline->flagUserChangedValue();
+}
+
+string ofxTLKeyframes::getBinaryFileName(){
+	return ofFilePath::removeExt(xmlFileName) + ".bin";
+}
+
 void ofxTLKeyframes::saveToBinaryFile(){
-	//write header
-	//# keyframes (int),
-	//size per keyframe (int)
-	//keyframe chain
-	string filePath = ofFilePath::removeExt(xmlFileName) + ".bin";
-	
-	int numKeys = keyframes.size();
-	int keyBytes = sizeof(unsigned long long) + sizeof(float); //time + value
-	cout << "saving binary file " << filePath << " with # keys " << numKeys << endl;
-	ofFile outfile(ofToDataPath(filePath), ofFile::WriteOnly, true);
-	outfile.write((char*)&numKeys,sizeof(int));
-	outfile.write((char*)&keyBytes, sizeof(int));
+	
+	//also closes the mapping so the file can be written over
+	materializeKeyframes();
+	
+	//store the payloads first, like the xml this gives subclasses a chance to modify time and value
+	ofxTLBinaryWriter payloads;
+	vector<unsigned long long> payloadOffsets(keyframes.size());
 	for(int i = 0; i < keyframes.size(); i++){
-		outfile.write( (char*)&keyframes[i]->time, sizeof(unsigned long long));
-		outfile.write( (char*)&keyframes[i]->value, sizeof(float));
+		payloadOffsets[i] = payloads.getData().size();
+		payloads.beginBlock();
+		storeKeyframeBinary(keyframes[i], payloads);
+		payloads.endBlock();
+	}
+	
+	ofxTLBinaryWriter writer;
+	writer.writeBytes(OFXTL_BINARY_MAGIC, 4);
+	writer.writeUInt32(OFXTL_BINARY_VERSION);
+	writer.writeString(getTrackType());
+	writer.writeUInt32(keyframes.size());
+	writer.writePadding(8);
+	for(int i = 0; i < keyframes.size(); i++){
+		writer.writeUInt64(keyframes[i]->time);
+	}
+	for(int i = 0; i < keyframes.size(); i++){
+		writer.writeFloat(keyframes[i]->value);
+	}
+	writer.writePadding(8);
+	unsigned long long payloadStart = writer.getData().size() + keyframes.size()*8;
+	for(int i = 0; i < keyframes.size(); i++){
+		writer.writeUInt64(payloadStart + payloadOffsets[i]);
+	}
+	writer.writeBytes(payloads.getData().c_str(), payloads.getData().size());
+	
+	ofBuffer buffer(writer.getData().c_str(), writer.getData().size());
+	if(!ofBufferToFile(getBinaryFileName(), buffer, true)){
+		ofLogError("ofxTLKeyframes::saveToBinaryFile") << "couldn't write " << getBinaryFileName();
 	}
-	outfile.close();
 }
 
-void ofxTLKeyframes::loadFromBinaryFile(){
+bool ofxTLKeyframes::loadFromBinaryFile(){
 	
-	string filePath = ofFilePath::removeExt(xmlFileName) + ".bin";
+	string filePath = getBinaryFileName();
+	if(!ofFile::doesFileExist(filePath)){
+		ofLogNotice("ofxTLKeyframes::loadFromBinaryFile") << "no binary file " << filePath;
+		return false;
+	}
 	
-	if(!ofFile(filePath).exists()){
-		cout << "binary file doesn't exist " << filePath << endl;
-		return;
+	clear();
+	if(useMappedLoading && mappedFile.open(filePath)){
+		if(mapKeyframes()){
+			return true;
+		}
+		//too small or the wrong kind of track to keep mapped, still saves copying the file into a buffer
+		bool loaded = readKeyframesFromBinary(mappedFile.getData(), mappedFile.size(), filePath);
+		mappedFile.close();
+		return loaded;
 	}
-	cout << " found file " << filePath << endl;
-	keyframes.clear();
-	ofFile infile(ofToDataPath(filePath), ofFile::ReadOnly, true);
-	int numKeys, keyBytes;
-	infile.read( (char*)&numKeys, sizeof(int) );
-	infile.read( (char*)&keyBytes, sizeof(int) );
-	cout << "# keys " << numKeys << " of size " << keyBytes << endl;
+	
+	ofBuffer buffer = ofBufferFromFile(filePath, true);
+	return readKeyframesFromBinary(buffer.getBinaryBuffer(), buffer.size(), filePath);
+}
+
+//reads every key in the file into keyframes, which should be empty
+bool ofxTLKeyframes::readKeyframesFromBinary(const char* data, size_t length, string filePath){
+	
+	ofxTLBinaryReader reader(data, length);
+	char magic[4];
+	reader.readBytes(magic, 4);
+	if(memcmp(magic, OFXTL_BINARY_MAGIC, 4) != 0){
+		//files from the old experimental format are a key count and size followed by time and value pairs
+		ofxTLBinaryReader legacyReader(data, length);
+		unsigned int numKeys = legacyReader.readUInt32();
+		unsigned int keyBytes = legacyReader.readUInt32();
+		if(!legacyReader.good() || keyBytes != 12 || legacyReader.getRemaining() != numKeys*keyBytes){
+			ofLogError("ofxTLKeyframes::loadFromBinaryFile") << filePath << " isn't a timeline binary file";
+			return false;
+		}
+		for(int i = 0; i < numKeys; i++){
+			ofxTLKeyframe* key = newKeyframe();
+			key->time = key->previousTime = legacyReader.readUInt64();
+			key->value = legacyReader.readFloat();
+			keyframes.push_back(key);
+		}
+		updateKeyframeSort();
+		return true;
+	}
+	
+	unsigned int version = reader.readUInt32();
+	if(version > OFXTL_BINARY_VERSION){
+		ofLogError("ofxTLKeyframes::loadFromBinaryFile") << filePath << " is version " << version << ", newer than this timeline can read";
+		return false;
+	}
+	
+	string trackType = reader.readString();
+	if(trackType != getTrackType()){
+		ofLogError("ofxTLKeyframes::loadFromBinaryFile") << filePath << " was saved by a " << trackType << " track, not " << getTrackType();
+		return false;
+	}
+	
+	unsigned int numKeys = reader.readUInt32();
+	//every key needs at least a time, value and payload length
+	if(!reader.good() || numKeys > reader.getRemaining() / 16){
+		ofLogError("ofxTLKeyframes::loadFromBinaryFile") << filePath << " is corrupt";
+		return false;
+	}
+	
+	if(version >= 2){
+		reader.skipPadding(8);
+	}
+	vector<unsigned long long> times(numKeys);
+	vector<float> values(numKeys);
 	for(int i = 0; i < numKeys; i++){
-		ofxTLKeyframe* k = newKeyframe();
-		infile.read( (char*)&k->time, sizeof(unsigned long long) );
-		infile.read( (char*)&k->value, sizeof(float) );
-		keyframes.push_back(k);
+		times[i] = reader.readUInt64();
+	}
+	for(int i = 0; i < numKeys; i++){
+		values[i] = reader.readFloat();
+	}
+	//the payloads follow each other, so the offsets are only needed for mapped files
+	if(version >= 2){
+		reader.skipPadding(8);
+		reader.skipBytes(numKeys*8);
+	}
+	for(int i = 0; i < numKeys; i++){
+		ofxTLKeyframe* key = newKeyframe();
+		key->time = key->previousTime = times[i];
+		key->value = values[i];
+		ofxTLBinaryReader payload = reader.readBlock();
+		restoreKeyframeBinary(key, payload);
+		keyframes.push_back(key);
+	}
+	
+	if(!reader.good()){
+		ofLogError("ofxTLKeyframes::loadFromBinaryFile") << filePath << " is corrupt";
+		clear();
+		return false;
+	}
+	
+	updateKeyframeSort();
+	return true;
+}
+
+//points the mapped columns into the open mapped file if this track can be sampled from it
+bool ofxTLKeyframes::mapKeyframes(){
+	
+	//the columns are little endian on disk
+	if(!canSampleMappedKeys() || !ofxTLBinaryHostIsLittleEndian()){
+		return false;
+	}
+	
+	ofxTLBinaryReader reader(mappedFile.getData(), mappedFile.size());
+	char magic[4];
+	reader.readBytes(magic, 4);
+	unsigned int version = reader.readUInt32();
+	string trackType = reader.readString();
+	unsigned int numKeys = reader.readUInt32();
+	reader.skipPadding(8);
+	if(!reader.good() || memcmp(magic, OFXTL_BINARY_MAGIC, 4) != 0 || version != OFXTL_BINARY_VERSION ||
+	   trackType != getTrackType() || numKeys < OFXTL_MIN_MAPPED_KEYS || numKeys > reader.getRemaining() / 24)
+	{
+		return false;
 	}
+	
+	const char* columns = mappedFile.getData() + reader.getPosition();
+	mappedTimes = (const unsigned long long*)columns;
+	mappedValues = (const float*)(columns + numKeys*8);
+	numMappedKeys = numKeys;
+	playbackCursor.reset();
 	shouldRecomputePreviews = true;
+	return true;
+}
+
+void ofxTLKeyframes::unmapKeyframes(){
+	mappedTimes = NULL;
+	mappedValues = NULL;
+	numMappedKeys = 0;
+	mappedFile.close();
+}
+
+bool ofxTLKeyframes::isMapped() const{
+	return numMappedKeys > 0;
+}
+
+void ofxTLKeyframes::materializeKeyframes(){
+	if(!isMapped()){
+		return;
+	}
+	
+	//keep the file open while the keys are read, readKeyframesFromBinary clears the track if the file is bad
+	mappedTimes = NULL;
+	mappedValues = NULL;
+	numMappedKeys = 0;
+	readKeyframesFromBinary(mappedFile.getData(), mappedFile.size(), mappedFile.getPath());
+	mappedFile.close();
+	playbackCursor.reset();
+	shouldRecomputePreviews = true;
+}
+
+ofxTLBinaryReader ofxTLKeyframes::getMappedPayload(int keyIndex) const{
+	//the offsets column follows the values, padded to 8 bytes
+	size_t valuesEnd = ((const char*)mappedValues - mappedFile.getData()) + numMappedKeys*4;
+	size_t offsetsStart = (valuesEnd + 7) / 8 * 8;
+	const unsigned long long* payloadOffsets = (const unsigned long long*)(mappedFile.getData() + offsetsStart);
+	unsigned long long payloadOffset = payloadOffsets[keyIndex];
+	if(payloadOffset >= mappedFile.size()){
+		return ofxTLBinaryReader(NULL, 0);
+	}
+	ofxTLBinaryReader reader(mappedFile.getData() + payloadOffset, mappedFile.size() - payloadOffset);
+	return reader.readBlock();
+}
+
+void ofxTLKeyframes::restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader){
+	ofxXmlSettings xmlStore;
+	string xmlRep = reader.readString();
+	if(xmlRep != ""){
+		xmlStore.loadFromBuffer(xmlRep);
+	}
+	restoreKeyframe(key, xmlStore);
+}
+
+void ofxTLKeyframes::storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer){
+	ofxXmlSettings xmlStore;
+	storeKeyframe(key, xmlStore);
+	string xmlRep;
+	xmlStore.copyXmlToString(xmlRep);
+	writer.writeString(xmlRep);
 }
 
 void ofxTLKeyframes::keyPressed(ofKeyEventArgs& args){
@@ -773,7 +1419,7 @@ void ofxTLKeyframes::deleteSelectedKeyframes(){
 			if(keyframes[i] == hoverKeyframe){
 				hoverKeyframe = NULL;
 			}
-			delete keyframes[i];
+			releaseKeyframe(keyframes[i]);
 			keyframes.erase(keyframes.begin()+i);
 			selectedKeyframes.erase(--selectedIt);
 		}
@@ -793,8 +1439,9 @@ void ofxTLKeyframes::deleteKeyframe(ofxTLKeyframe* keyframe){
 		if(keyframe == keyframes[i]){
 			deselectKeyframe(keyframe);
 			willDeleteKeyframe(keyframes[i]);
-			delete keyframes[i];
+			releaseKeyframe(keyframes[i]);
 			keyframes.erase(keyframes.begin()+i);
+			updateKeyframeColumns();
 			return;
 		}
 	}
@@ -867,10 +1514,20 @@ float ofxTLKeyframes::valueToScreenY(float value){
 }
 
 ofxTLKeyframe* ofxTLKeyframes::newKeyframe(){
-	ofxTLKeyframe* k = new ofxTLKeyframe();
+	ofxTLKeyframe* k = createKeyframe<ofxTLKeyframe>();
 	return k;
 }
 
+void ofxTLKeyframes::destroyKeyframe(ofxTLKeyframe* key){
+	if(keyframePool.owns(key)){
+		key->~ofxTLKeyframe();
+		keyframePool.release(key);
+	}
+	else{
+		delete key;
+	}
+}
+
 string ofxTLKeyframes::getTrackType(){
     return "Keyframes";
 }
\ No newline at end of file
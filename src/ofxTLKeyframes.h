@@ -36,9 +36,18 @@
 #include "ofRange.h"
 #include "ofxTLTrack.h"
 #include "ofxXmlSettings.h"
+#include "ofxTLKeyframePool.h"
+#include "ofxTLBinaryFormat.h"
+#include "ofxTLMappedFile.h"
+#include "ofxTLXmlKeyReader.h"
+#include "ofxTLKeyframesUndoDelta.h"
+
+//binary files with fewer keys than this are always loaded into keyframes
+#define OFXTL_MIN_MAPPED_KEYS 10000
 
 class ofxTLKeyframe {
   public:
+	virtual ~ofxTLKeyframe(){}
 	ofVec2f screenPosition; // cached screen position
 	unsigned long long previousTime; //for preventing overlap conflicts
     unsigned long long time; //in millis
@@ -47,6 +56,16 @@ class ofxTLKeyframe {
     float grabValueOffset;
 };
 
+//search position for sampling a keyframe track
+//the const sampling functions never write to the track, so each thread
+//that samples keeps its own cursor and many can sample one track at once
+class ofxTLKeyframeCursor {
+  public:
+	ofxTLKeyframeCursor() : keyframeIndex(1) {}
+	void reset(){ keyframeIndex = 1; }
+	int keyframeIndex; //last keyframe found, checked first on the next sample
+};
+
 class ofxTLKeyframes : public ofxTLTrack
 {
   public:	
@@ -68,6 +87,12 @@ class ofxTLKeyframes : public ofxTLTrack
 	
 	virtual void save();
 	virtual void load();
+	//keyframes are read without touching GL, so they can be loaded in parallel once a subclass has checked that
+	//its newKeyframe and restoreKeyframe don't touch the timeline, GL or anything outside the track.
+	//false here, subclasses that are safe return true from canLoadOnThread()
+	virtual bool canLoadOnThread();
+	virtual void loadOnThread();
+	virtual void finishLoad();
 	
 	virtual void clear();
 
@@ -77,6 +102,8 @@ class ofxTLKeyframes : public ofxTLTrack
 	virtual void addKeyframeAtMillis(float value, unsigned long long millis);
 	
     vector<ofxTLKeyframe*>& getKeyframes();
+	//allocation counters for this track's keyframes
+	const ofxTLKeyframePool& getKeyframePool() const;
     
 	//copy paste
 	virtual string copyRequest();
@@ -95,6 +122,12 @@ class ofxTLKeyframes : public ofxTLTrack
     //undo
     virtual string getXMLRepresentation();
     virtual void loadFromXMLRepresentation(string rep);
+	//edits are recorded as the keys they touch, see ofxTLKeyframesUndoDelta.h
+	//subclasses that change keys other than through setKeyframeTime, keyframeWillChange, keyframeWasAdded
+	//and the delete functions should return false to be stored as xml instead
+	virtual bool supportsUndoDeltas();
+	virtual void beginUndoDelta();
+	virtual ofxTLUndoDelta* endUndoDelta();
     
     virtual void regionSelected(ofLongRange timeRange, ofRange valueRange);
 	
@@ -104,6 +137,20 @@ class ofxTLKeyframes : public ofxTLTrack
 	virtual float getValue();
 	virtual float getValueAtPercent(float percent);
 	virtual float getValueAtTimeInMillis(long sampleTime);
+	
+	//thread safe sampling, doesn't modify the track
+	//pass a cursor owned by the calling thread to keep sequential sampling fast, or NULL
+	//keyframes must not be edited while other threads are sampling
+	//the versions without a cursor call these with the playback cursor, so override these ones
+	float getValueAtPercent(float percent, ofxTLKeyframeCursor* cursor) const;
+	virtual float getValueAtTimeInMillis(long sampleTime, ofxTLKeyframeCursor* cursor) const;
+	
+	//fills values with count samples spaced evenly from startMillis to endMillis, both included
+	//walks the keyframes once rather than searching for each sample, for exporting at audio or control rates
+	//thread safe like the cursor functions
+	void getValuesInRange(unsigned long long startMillis, unsigned long long endMillis, int count, float* values) const;
+	//the same walk with samples sampleRate per second apart from startMillis, for rates that don't fall on whole millis
+	void getValuesAtRate(double startMillis, double sampleRate, int count, float* values) const;
 
 	virtual void setValueRange(ofRange range, float defaultValue = 0);
 	virtual void setValueRangeMin(float min);
@@ -114,15 +161,73 @@ class ofxTLKeyframes : public ofxTLTrack
 	
     virtual ofRange getValueRange();
 	
-	//experimental binary saving. does not work with subclasses yet
+	//binary saving, much faster to load than xml for big tracks
+	//see ofxTLBinaryFormat.h for the layout
 	void saveToBinaryFile();
-	void loadFromBinaryFile();
+	bool loadFromBinaryFile();
+	string getBinaryFileName();
 	bool useBinarySave;
 	
+	//big binary files are memory mapped and sampled in place instead of being loaded into keyframes
+	//the keyframes are only created when the track is first edited, so opening and playing back
+	//recorded data is nearly free. the mapped keys can't be hovered until then
+	bool useMappedLoading;
+	bool isMapped() const;
+	
   protected:
 	virtual ofxTLKeyframe* newKeyframe();
 	vector<ofxTLKeyframe*> keyframes;
 	
+	//subclasses create their keys in newKeyframe() with createKeyframe<KeyType>() so they come from the pool
+	//keys made with new still work, destroyKeyframe() deletes anything the pool didn't allocate
+	template<class KeyType>
+	KeyType* createKeyframe(){
+		return new (keyframePool.allocate(sizeof(KeyType))) KeyType();
+	}
+	void destroyKeyframe(ofxTLKeyframe* key);
+	ofxTLKeyframePool keyframePool;
+	
+	//contiguous copies of each key's time and value in keyframe order
+	//searching and scanning these stays in cache where chasing the keyframe pointers doesn't
+	//updateKeyframeSort rebuilds them, call updateKeyframeColumns after changing times or values without sorting
+	//setKeyframeTime marks them stale, and until they're rebuilt searches go through the keyframes instead
+	vector<unsigned long long> keyTimes;
+	vector<float> keyValues;
+	bool keyColumnsValid;
+	bool hasKeyColumns() const;
+	virtual void updateKeyframeColumns();
+	//addKeyframeAtMillis calls this instead of updateKeyframeColumns when the new key goes after the last one
+	//the default appends it to the columns, subclasses that keep something per key in updateKeyframeColumns add to that too
+	virtual void keyframeAppended(ofxTLKeyframe* key);
+	
+	//reads the keyframes from the binary or xml file, false if there wasn't one
+	bool loadKeyframeFiles();
+	bool loadedOnThread;
+	//true while loadOnThread runs, anything that writes timeline state waits for finishLoad
+	bool loadingOnThread;
+	//stretches the timeline to the last key
+	void fitDurationToKeyframes();
+	
+	//columns used in place from a memory mapped binary file, while the keyframes vector is empty
+	ofxTLMappedFile mappedFile;
+	const unsigned long long* mappedTimes;
+	const float* mappedValues;
+	int numMappedKeys;
+	bool mapKeyframes();
+	void unmapKeyframes();
+	//creates the keyframes from the mapped file, call before anything that changes or hands out the keyframes
+	void materializeKeyframes();
+	bool readKeyframesFromBinary(const char* data, size_t length, string filePath);
+	//the storeKeyframeBinary payload of a mapped key
+	ofxTLBinaryReader getMappedPayload(int keyIndex) const;
+	//tracks that need their keyframe objects to sample or draw return false and are always fully loaded
+	//override this if you override interpolateValueForKeys, along with interpolateMappedKeys
+	virtual bool canSampleMappedKeys() const { return true; }
+	//interpolateValueForKeys for mapped keys, by index
+	virtual float interpolateMappedKeys(int startIndex, int endIndex, unsigned long long sampleTime) const;
+	//the same for the keyframes, for tracks that keep something of their own per key index
+	virtual float interpolateKeysAtIndices(int startIndex, int endIndex, unsigned long long sampleTime) const;
+	
 	//cached previews for fast drawing of large timelines
 	ofPolyline preview;
 	vector<ofVec2f> keyPoints;
@@ -132,15 +237,27 @@ class ofxTLKeyframes : public ofxTLTrack
 	
 	virtual float sampleAtPercent(float percent); //less accurate than millis
     virtual float sampleAtTime(long sampleTime);
-	virtual float interpolateValueForKeys(ofxTLKeyframe* start,ofxTLKeyframe* end, unsigned long long sampleTime);
-	virtual float evaluateKeyframeAtTime(ofxTLKeyframe* key, unsigned long long sampleTime, bool firstKey = false);
+	//every sample goes through here, override this rather than sampleAtTime(long) or the cursor paths will miss it
+	virtual float sampleAtTime(long sampleTime, ofxTLKeyframeCursor* cursor) const;
+	//these are called from the const sampling functions and may run on several threads at once
+	//they used to be non-const. an override without const no longer overrides them and is silently never called,
+	//so subclasses written against the old signatures have to add const
+	virtual float interpolateValueForKeys(ofxTLKeyframe* start,ofxTLKeyframe* end, unsigned long long sampleTime) const;
+	virtual float evaluateKeyframeAtTime(ofxTLKeyframe* key, unsigned long long sampleTime, bool firstKey = false) const;
+	//normalized version of getValuesInRange
+	void sampleRange(double startMillis, double endMillis, int count, float* samples) const;
+	//fills count samples sampleStep millis apart from firstSampleTime, all of them between the start and end key
+	//the default calls interpolateValueForKeys for each sample, override it with a tighter loop where possible
+	virtual void interpolateValuesForKeys(ofxTLKeyframe* start, ofxTLKeyframe* end, double firstSampleTime, double sampleStep, int count, float* samples) const;
+	//the same for the samples after the last key, calls evaluateKeyframeAtTime for each by default
+	virtual void evaluateValuesForKey(ofxTLKeyframe* key, double firstSampleTime, double sampleStep, int count, float* samples) const;
 
     ofRange valueRange;
 	float defaultValue;
 	
-	//keep these stored for efficient search through the keyframe array
-	int lastKeyframeIndex;
-	unsigned long long lastSampleTime;
+	//keep this stored for efficient search through the keyframe array during playback
+	ofxTLKeyframeCursor playbackCursor;
+	int keyframeIndexForTime(unsigned long long sampleTime, ofxTLKeyframeCursor* cursor = NULL) const;
 	
     virtual ofxTLKeyframe* keyframeAtScreenpoint(ofVec2f p);
 	bool isKeyframeIsInBounds(ofxTLKeyframe* key);
@@ -154,6 +271,20 @@ class ofxTLKeyframes : public ofxTLTrack
 	//instead implement special behavior here:
 	//this is called before the keyframe is deleted and removed from the keyframes vector
 	virtual void willDeleteKeyframe(ofxTLKeyframe* keyframe){};
+	//destroys a key that was taken out of the keyframes vector, or gives it to the undo delta being recorded
+	void releaseKeyframe(ofxTLKeyframe* keyframe);
+	
+	//undo recording
+	friend class ofxTLKeyframesUndoDelta;
+	ofxTLKeyframesUndoDelta* recordingDelta; //NULL unless an edit is being recorded
+	//call before changing anything storeKeyframeBinary saves, setKeyframeTime already does
+	void keyframeWillChange(ofxTLKeyframe* key);
+	//call for new keys as they're added to keyframes
+	void keyframeWasAdded(ofxTLKeyframe* key);
+	//changed whenever keys are destroyed without being recorded, deltas from before then no longer apply
+	int undoGeneration;
+	//takes removed out of the keyframes, merges added in by time and clears the selection
+	void exchangeKeyframes(const set<ofxTLKeyframe*>& removed, vector<ofxTLKeyframe*>& added);
 	
 	vector<ofxTLKeyframe*> selectedKeyframes;
     ofxTLKeyframe* selectedKeyframe;
@@ -171,9 +302,20 @@ class ofxTLKeyframes : public ofxTLTrack
 	virtual void updateDragOffsets(ofVec2f screenpoint, long grabMillis);
 
 	virtual string getXMLStringForKeyframes(vector<ofxTLKeyframe*>& keys);
-	virtual void createKeyframesFromXML(ofxXmlSettings xml, vector<ofxTLKeyframe*>& keyContainer);
+	virtual void createKeyframesFromXML(ofxXmlSettings& xml, vector<ofxTLKeyframe*>& keyContainer);
+	//reads keys straight out of saved xml text in one pass, without building a document
+	//used for loading, undo and paste. adds nothing and returns false if the xml is broken
+	bool createKeyframesFromXMLText(const char* data, size_t length, vector<ofxTLKeyframe*>& keyContainer);
 	virtual void restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore){};
     virtual void storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore){};
+	//restoreKeyframe for keys read by createKeyframesFromXMLText, keyValues holds the key's values
+	//the default copies them into a small xml document for restoreKeyframe, which is slower than loading the old way
+	//subclasses that restore anything should override it to read their values directly, as all of the addon's tracks do
+	virtual void restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues);
+	//binary versions of restoreKeyframe and storeKeyframe, time and value are already handled
+	//the defaults save whatever storeKeyframe writes as xml text so subclasses work without them
+	virtual void restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader);
+	virtual void storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer);
 
     virtual void selectedKeySecondaryClick(ofMouseEventArgs& args){};
 	
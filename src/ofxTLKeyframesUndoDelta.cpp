@@ -0,0 +1,229 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "ofxTLKeyframesUndoDelta.h"
+#include "ofxTLKeyframes.h"
+
+ofxTLKeyframesUndoDelta::ofxTLKeyframesUndoDelta(ofxTLKeyframes* track, int generation)
+:	track(track),
+	generation(generation),
+	undone(false)
+{
+	
+}
+
+ofxTLKeyframesUndoDelta::~ofxTLKeyframesUndoDelta(){
+	for(int i = 0; i < changes.size(); i++){
+		bool inTrack = undone ? changes[i].existedBefore : changes[i].existsAfter;
+		if(!inTrack && changes[i].key != NULL){
+			track->destroyKeyframe(changes[i].key);
+		}
+	}
+}
+
+void ofxTLKeyframesUndoDelta::undo(){
+	apply(true);
+}
+
+void ofxTLKeyframesUndoDelta::redo(){
+	apply(false);
+}
+
+int ofxTLKeyframesUndoDelta::getNumChanges(){
+	return changes.size();
+}
+
+size_t ofxTLKeyframesUndoDelta::getMemoryUsage(){
+	size_t bytes = sizeof(ofxTLKeyframesUndoDelta) + changes.capacity()*sizeof(ofxTLKeyframeChange);
+	for(int i = 0; i < changes.size(); i++){
+		bytes += changes[i].payloadBefore.capacity() + changes[i].payloadAfter.capacity();
+		//count the keys held outside the track too
+		if(!changes[i].existedBefore || !changes[i].existsAfter){
+			bytes += sizeof(ofxTLKeyframe);
+		}
+	}
+	return bytes;
+}
+
+bool ofxTLKeyframesUndoDelta::coalesce(ofxTLUndoDelta* next){
+	ofxTLKeyframesUndoDelta* nextDelta = dynamic_cast<ofxTLKeyframesUndoDelta*>(next);
+	if(nextDelta == NULL || nextDelta->track != track || nextDelta->generation != generation || undone || nextDelta->undone){
+		return false;
+	}
+	
+	map<ofxTLKeyframe*, int> index;
+	for(int i = 0; i < changes.size(); i++){
+		index[changes[i].key] = i;
+	}
+	//only edits that change keys this one left in the track, adding or removing keys is its own step
+	for(int i = 0; i < nextDelta->changes.size(); i++){
+		ofxTLKeyframeChange& change = nextDelta->changes[i];
+		map<ofxTLKeyframe*, int>::iterator it = index.find(change.key);
+		if(!change.existedBefore || !change.existsAfter || it == index.end() || !changes[it->second].existsAfter){
+			return false;
+		}
+	}
+	
+	for(int i = 0; i < nextDelta->changes.size(); i++){
+		ofxTLKeyframeChange& change = nextDelta->changes[i];
+		ofxTLKeyframeChange& mine = changes[index[change.key]];
+		mine.timeAfter = change.timeAfter;
+		mine.valueAfter = change.valueAfter;
+		mine.payloadAfter = change.payloadAfter;
+	}
+	return true;
+}
+
+void ofxTLKeyframesUndoDelta::keyWillChange(ofxTLKeyframe* key){
+	if(changeIndex.find(key) != changeIndex.end()){
+		return;
+	}
+	
+	ofxTLKeyframeChange change;
+	change.key = key;
+	change.existedBefore = true;
+	change.existsAfter = true;
+	change.timeBefore = change.timeAfter = key->time;
+	change.valueBefore = change.valueAfter = key->value;
+	change.payloadBefore = storePayload(key);
+	changeIndex[key] = changes.size();
+	changes.push_back(change);
+}
+
+void ofxTLKeyframesUndoDelta::keyWasAdded(ofxTLKeyframe* key){
+	map<ofxTLKeyframe*, int>::iterator it = changeIndex.find(key);
+	if(it != changeIndex.end()){
+		changes[it->second].existsAfter = true;
+		return;
+	}
+	
+	ofxTLKeyframeChange change;
+	change.key = key;
+	change.existedBefore = false;
+	change.existsAfter = true;
+	change.timeBefore = change.timeAfter = key->time;
+	change.valueBefore = change.valueAfter = key->value;
+	changeIndex[key] = changes.size();
+	changes.push_back(change);
+}
+
+void ofxTLKeyframesUndoDelta::keyWasRemoved(ofxTLKeyframe* key){
+	keyWillChange(key);
+	map<ofxTLKeyframe*, int>::iterator it = changeIndex.find(key);
+	ofxTLKeyframeChange& change = changes[it->second];
+	change.existsAfter = false;
+	//a key added and removed within the same edit never needs to come back
+	if(!change.existedBefore){
+		track->destroyKeyframe(key);
+		change.key = NULL;
+		changeIndex.erase(it);
+	}
+}
+
+bool ofxTLKeyframesUndoDelta::finish(){
+	changeIndex.clear();
+	
+	int numKept = 0;
+	for(int i = 0; i < changes.size(); i++){
+		ofxTLKeyframeChange& change = changes[i];
+		if(change.key == NULL){
+			continue;
+		}
+		if(change.existsAfter){
+			change.timeAfter = change.key->time;
+			change.valueAfter = change.key->value;
+			change.payloadAfter = storePayload(change.key);
+			if(change.existedBefore &&
+			   change.timeAfter == change.timeBefore &&
+			   change.valueAfter == change.valueBefore &&
+			   change.payloadAfter == change.payloadBefore)
+			{
+				continue;
+			}
+		}
+		if(numKept != i){
+			changes[numKept] = change;
+		}
+		numKept++;
+	}
+	changes.resize(numKept);
+	
+	//the delta may sit on the undo stack for a long time, don't keep the recording's spare capacity
+	vector<ofxTLKeyframeChange>(changes).swap(changes);
+	return numKept > 0;
+}
+
+void ofxTLKeyframesUndoDelta::apply(bool toBefore){
+	//the keys this was recorded against are gone
+	if(generation != track->undoGeneration || undone == toBefore){
+		return;
+	}
+	
+	set<ofxTLKeyframe*> leaving;
+	vector<ofxTLKeyframe*> arriving;
+	for(int i = 0; i < changes.size(); i++){
+		ofxTLKeyframeChange& change = changes[i];
+		bool wasInTrack = toBefore ? change.existsAfter : change.existedBefore;
+		bool willBeInTrack = toBefore ? change.existedBefore : change.existsAfter;
+		if(willBeInTrack){
+			unsigned long long time = toBefore ? change.timeBefore : change.timeAfter;
+			bool moved = change.key->time != time;
+			change.key->time = change.key->previousTime = time;
+			change.key->value = toBefore ? change.valueBefore : change.valueAfter;
+			if(change.payloadBefore != change.payloadAfter){
+				string& payload = toBefore ? change.payloadBefore : change.payloadAfter;
+				ofxTLBinaryReader reader(payload.data(), payload.size());
+				track->restoreKeyframeBinary(change.key, reader);
+			}
+			//moved keys are taken out and merged back in at their new place
+			if(wasInTrack && moved){
+				leaving.insert(change.key);
+				arriving.push_back(change.key);
+			}
+			else if(!wasInTrack){
+				arriving.push_back(change.key);
+			}
+		}
+		else if(wasInTrack){
+			leaving.insert(change.key);
+		}
+	}
+	
+	track->exchangeKeyframes(leaving, arriving);
+	undone = toBefore;
+}
+
+string ofxTLKeyframesUndoDelta::storePayload(ofxTLKeyframe* key){
+	ofxTLBinaryWriter writer;
+	track->storeKeyframeBinary(key, writer);
+	return writer.getData();
+}
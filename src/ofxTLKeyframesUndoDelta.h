@@ -0,0 +1,93 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxTLUndoDelta.h"
+
+class ofxTLKeyframe;
+class ofxTLKeyframes;
+
+//a key touched by an edit, with everything needed to put it back either way
+class ofxTLKeyframeChange {
+  public:
+	ofxTLKeyframe* key;
+	bool existedBefore;
+	bool existsAfter;
+	unsigned long long timeBefore;
+	unsigned long long timeAfter;
+	float valueBefore;
+	float valueAfter;
+	//what storeKeyframeBinary writes, for subclass data like easing
+	string payloadBefore;
+	string payloadAfter;
+};
+
+//The keys one edit added, removed or changed on an ofxTLKeyframes track.
+//Undo and redo only touch those keys, so their cost follows the size of the edit rather than the track.
+//Keys that are out of the track, removed ones after the edit or added ones after undo, belong to the
+//delta and are destroyed with it. If the track is cleared or loaded the delta no longer applies and does nothing.
+class ofxTLKeyframesUndoDelta : public ofxTLUndoDelta {
+  public:
+	ofxTLKeyframesUndoDelta(ofxTLKeyframes* track, int generation);
+	virtual ~ofxTLKeyframesUndoDelta();
+	
+	virtual void undo();
+	virtual void redo();
+	virtual size_t getMemoryUsage();
+	//combines edits that only moved or changed keys the first edit already touched, like a run of nudges
+	virtual bool coalesce(ofxTLUndoDelta* next);
+	
+	int getNumChanges();
+	
+  protected:
+	friend class ofxTLKeyframes;
+	
+	//recording, called by the track while the edit happens
+	void keyWillChange(ofxTLKeyframe* key);
+	void keyWasAdded(ofxTLKeyframe* key);
+	//the key has left the track and is handed to the delta
+	void keyWasRemoved(ofxTLKeyframe* key);
+	//reads the state after the edit and drops keys that ended up unchanged, false if nothing is left
+	bool finish();
+	
+	void apply(bool toBefore);
+	string storePayload(ofxTLKeyframe* key);
+	
+	ofxTLKeyframes* track;
+	int generation;
+	bool undone;
+	vector<ofxTLKeyframeChange> changes;
+	//only used while recording
+	map<ofxTLKeyframe*, int> changeIndex;
+};
@@ -34,6 +34,36 @@
 #include "ofxTimeline.h"
 #include "ofxHotKeys.h"
 
+//samples between restarting a run's rotation from an exact cos and sin
+static const int lfoReseedInterval = 512;
+
+//fills cosines with cos(phase + phaseStep*n + phaseCurve*n*n) for n from 0 to count-1
+//rotating by the step each sample and turning the step by twice the curve is two complex multiplies instead of a cos,
+//a constant frequency has no curve and a linear chirp's phase is quadratic in time
+static void cosineRun(double phase, double phaseStep, double phaseCurve, int count, float* cosines){
+	double turnReal = cos(2*phaseCurve);
+	double turnImag = sin(2*phaseCurve);
+	for(int first = 0; first < count; first += lfoReseedInterval){
+		double n = first;
+		double phaseNow = phase + n*(phaseStep + n*phaseCurve);
+		double stepNow = phaseStep + phaseCurve*(2*n + 1);
+		double real = cos(phaseNow);
+		double imag = sin(phaseNow);
+		double stepReal = cos(stepNow);
+		double stepImag = sin(stepNow);
+		int last = MIN(first + lfoReseedInterval, count);
+		for(int i = first; i < last; i++){
+			cosines[i] = real;
+			double nextReal = real*stepReal - imag*stepImag;
+			imag = real*stepImag + imag*stepReal;
+			real = nextReal;
+			double nextStepReal = stepReal*turnReal - stepImag*turnImag;
+			stepImag = stepReal*turnImag + stepImag*turnReal;
+			stepReal = nextStepReal;
+		}
+	}
+}
+
 ofxTLLFO::ofxTLLFO(){
 	drawingLFORect = false;
 	rectWidth = 120;
@@ -174,7 +204,7 @@ void ofxTLLFO::draw(){
 	ofPopStyle();
 }
 
-float ofxTLLFO::interpolateValueForKeys(ofxTLKeyframe* start, ofxTLKeyframe* end, unsigned long long sampleTime){
+float ofxTLLFO::interpolateValueForKeys(ofxTLKeyframe* start, ofxTLKeyframe* end, unsigned long long sampleTime) const{
 	ofxTLLFOKey* prevKey = (ofxTLLFOKey*)start;
 //	prevKey->samplePoint = (1./prevKey->frequency)*(prevKey->phaseShift + prevKey->time + sampleTime );
 	
@@ -191,6 +221,7 @@ float ofxTLLFO::interpolateValueForKeys(ofxTLKeyframe* start, ofxTLKeyframe* end
 		ofxTLLFOKey tempkey;
 		tempkey.time = prevKey->time;
 		tempkey.type = prevKey->type;
+		tempkey.seed = prevKey->seed;
 		
 		tempkey.phaseShift = ofMap(sampleTime, prevKey->time, nextKey->time, prevKey->phaseShift, nextKey->phaseShift);
 		tempkey.amplitude = ofMap(sampleTime, prevKey->time, nextKey->time, prevKey->amplitude, nextKey->amplitude);
@@ -235,8 +266,101 @@ float ofxTLLFO::interpolateValueForKeys(ofxTLKeyframe* start, ofxTLKeyframe* end
 	}
 }
 
+//the buffer versions of interpolateValueForKeys and evaluateKeyframeAtTime work out each run's constants once
+//and step sine phases with cosineRun, exponential chirps multiply their growth along instead of calling pow
+//they sample at the exact fractional times rather than the millisecond below like the single sample functions
+//and keep the phase in doubles, at whole millis they're within 1e-7 of the track range of the same math done in doubles
+//the single sample functions add the phase shift to the time and take the exponential chirp's log as floats,
+//so they drift from these with frequency and time, by about 3e-3 of the range at 600 cycles a minute half an hour in
+void ofxTLLFO::interpolateValuesForKeys(ofxTLKeyframe* start, ofxTLKeyframe* end, double firstSampleTime, double sampleStep, int count, float* samples) const{
+	ofxTLLFOKey* prevKey = (ofxTLLFOKey*)start;
+	ofxTLLFOKey* nextKey = (ofxTLLFOKey*)end;
+	if(!prevKey->interpolate && !prevKey->expInterpolate){
+		evaluateValuesForKey(prevKey, firstSampleTime, sampleStep, count, samples);
+		return;
+	}
+	
+	double span = nextKey->time - prevKey->time;
+	double firstOffset = firstSampleTime - prevKey->time;
+	if(prevKey->type != nextKey->type){
+		vector<float> nextValues(count);
+		evaluateValuesForKey(prevKey, firstSampleTime, sampleStep, count, samples);
+		evaluateValuesForKey(nextKey, firstSampleTime, sampleStep, count, &nextValues[0]);
+		for(int i = 0; i < count; i++){
+			float delta = (firstOffset + sampleStep*i) / span;
+			samples[i] += (nextValues[i] - samples[i]) * delta;
+		}
+		return;
+	}
+	
+	if(prevKey->type == OFXTL_LFO_TYPE_NOISE){
+		for(int i = 0; i < count; i++){
+			double offset = firstOffset + sampleStep*i;
+			float delta = offset / span;
+			float phaseShift = prevKey->phaseShift + (nextKey->phaseShift - prevKey->phaseShift) * delta;
+			float frequency = prevKey->frequency + (nextKey->frequency - prevKey->frequency) * delta;
+			float amplitude = prevKey->amplitude + (nextKey->amplitude - prevKey->amplitude) * delta;
+			float center = prevKey->center + (nextKey->center - prevKey->center) * delta;
+			samples[i] = ofClamp((ofSignedNoise(prevKey->seed, (2*PI*frequency/(1000*60*10))*(phaseShift + prevKey->time + offset)) * amplitude)*.5+.5 + center, 0, 1);
+		}
+		return;
+	}
+	
+	if(!prevKey->expInterpolate){
+		//the chirp's phase is linearRate*offset + curveRate*offset^2 plus the shift, offset in millis from the previous key
+		double linearRate = 2*PI*prevKey->frequency / (60.0*1000.0);
+		double curveRate = 2*PI*(nextKey->frequency - prevKey->frequency) / (2*span*60.0*1000.0);
+		cosineRun(prevKey->phaseShift + firstOffset*(linearRate + curveRate*firstOffset),
+				  sampleStep*(linearRate + 2*curveRate*firstOffset),
+				  curveRate*sampleStep*sampleStep,
+				  count, samples);
+		for(int i = 0; i < count; i++){
+			float delta = (firstOffset + sampleStep*i) / span;
+			float amplitude = prevKey->amplitude + (nextKey->amplitude - prevKey->amplitude) * delta;
+			float center = prevKey->center + (nextKey->center - prevKey->center) * delta;
+			samples[i] = ofClamp(samples[i] * amplitude * 0.5 + 0.5 + center, 0, 1.0);
+		}
+		return;
+	}
+	
+	//the exponential chirp divides by the log of the frequency ratio, leave the cases that breaks to the single sample math
+	if(prevKey->frequency <= 0 || nextKey->frequency <= 0 || prevKey->frequency == nextKey->frequency){
+		ofxTLKeyframes::interpolateValuesForKeys(start, end, firstSampleTime, sampleStep, count, samples);
+		return;
+	}
+	//k^t from interpolateValueForKeys is ratio^(offset/span)
+	double ratio = nextKey->frequency / prevKey->frequency;
+	double phaseScale = 2*PI*prevKey->frequency * (span / (60.0*1000.0)) / log(ratio);
+	double growth = pow(ratio, sampleStep / span);
+	for(int first = 0; first < count; first += lfoReseedInterval){
+		double power = pow(ratio, (firstOffset + sampleStep*first) / span);
+		int last = MIN(first + lfoReseedInterval, count);
+		for(int i = first; i < last; i++){
+			samples[i] = ofClamp(cos(phaseScale * (power - 1)) * 0.5 + 0.5, 0, 1.0);
+			power *= growth;
+		}
+	}
+}
+
+void ofxTLLFO::evaluateValuesForKey(ofxTLKeyframe* key, double firstSampleTime, double sampleStep, int count, float* samples) const{
+	ofxTLLFOKey* lfo = (ofxTLLFOKey*)key;
+	if(lfo->type == OFXTL_LFO_TYPE_SINE){
+		double radiansPerMilli = 2*PI*lfo->frequency / (1000.0*60.0);
+		cosineRun(radiansPerMilli * (firstSampleTime + lfo->phaseShift), radiansPerMilli * sampleStep, 0, count, samples);
+		for(int i = 0; i < count; i++){
+			samples[i] = ofClamp((samples[i]*lfo->amplitude)*.5 + .5 + lfo->center, 0, 1);
+		}
+	}
+	else {
+		double noiseRate = 2*PI*lfo->frequency/(1000*60*10);
+		for(int i = 0; i < count; i++){
+			samples[i] = ofClamp( (ofSignedNoise(lfo->seed, noiseRate*(lfo->phaseShift + firstSampleTime + sampleStep*i)) * lfo->amplitude)*.5+.5 + lfo->center, 0, 1);
+		}
+	}
+}
+
 //the beating heart
-float ofxTLLFO::evaluateKeyframeAtTime(ofxTLKeyframe* key, unsigned long long sampleTime, bool firstKey){
+float ofxTLLFO::evaluateKeyframeAtTime(ofxTLKeyframe* key, unsigned long long sampleTime, bool firstKey) const{
     if(firstKey){
         return ofMap(defaultValue, valueRange.min, valueRange.max, 0, 1.0);
     }
@@ -404,7 +528,7 @@ string ofxTLLFO::getTrackType(){
 
 ofxTLKeyframe* ofxTLLFO::newKeyframe(){
 	//return our type of keyframe, stored in the parent class
-	ofxTLLFOKey* newKey = new ofxTLLFOKey();
+	ofxTLLFOKey* newKey = createKeyframe<ofxTLLFOKey>();
 	newKey->type = OFXTL_LFO_TYPE_SINE;
 	newKey->phaseShift = 0; //in millis
     newKey->phaseMatch = false;
@@ -429,6 +553,18 @@ void ofxTLLFO::restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore){
 	lfoKey->expInterpolate = xmlStore.getValue("expInterpolate", true);
 }
 
+void ofxTLLFO::restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues){
+	ofxTLLFOKey* lfoKey = (ofxTLLFOKey*)key;
+	lfoKey->type = (ofxTLLFOType)keyValues.getValue("type", int(OFXTL_LFO_TYPE_NOISE));
+	lfoKey->phaseShift = keyValues.getValue("phaseShift", 0.);
+	lfoKey->amplitude = keyValues.getValue("amplitude", 1.);
+	lfoKey->frequency = keyValues.getValue("frequency", 100.);
+	lfoKey->seed = keyValues.getValue("seed", 0.);
+	lfoKey->center = keyValues.getValue("center", 0.);
+	lfoKey->interpolate = keyValues.getValue("interpolate", true);
+	lfoKey->expInterpolate = keyValues.getValue("expInterpolate", true);
+}
+
 void ofxTLLFO::storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore){
 	ofxTLLFOKey* lfoKey = (ofxTLLFOKey*)key;
 	ofxTLLFOType type;
@@ -442,6 +578,30 @@ void ofxTLLFO::storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore){
 	xmlStore.addValue("expInterpolate",lfoKey->expInterpolate);
 }
 
+void ofxTLLFO::restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader){
+	ofxTLLFOKey* lfoKey = (ofxTLLFOKey*)key;
+	lfoKey->type = (ofxTLLFOType)reader.readUInt8();
+	lfoKey->phaseShift = reader.readFloat();
+	lfoKey->amplitude = reader.readFloat();
+	lfoKey->frequency = reader.readFloat();
+	lfoKey->seed = reader.readFloat();
+	lfoKey->center = reader.readFloat();
+	lfoKey->interpolate = reader.readUInt8();
+	lfoKey->expInterpolate = reader.readUInt8();
+}
+
+void ofxTLLFO::storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer){
+	ofxTLLFOKey* lfoKey = (ofxTLLFOKey*)key;
+	writer.writeUInt8(lfoKey->type);
+	writer.writeFloat(lfoKey->phaseShift);
+	writer.writeFloat(lfoKey->amplitude);
+	writer.writeFloat(lfoKey->frequency);
+	writer.writeFloat(lfoKey->seed);
+	writer.writeFloat(lfoKey->center);
+	writer.writeUInt8(lfoKey->interpolate);
+	writer.writeUInt8(lfoKey->expInterpolate);
+}
+
 void ofxTLLFO::selectedKeySecondaryClick(ofMouseEventArgs& args){
 	drawingLFORect = true;
 	lfoRect = ofRectangle(args.x,args.y, 40,40);
@@ -89,11 +89,18 @@ class ofxTLLFO : public ofxTLKeyframes {
 
 	//return a custom name for this keyframe
 	virtual string getTrackType();
+	virtual bool supportsUndoDeltas(){ return false; }
+	//lfo keys only hold their own settings, so they can load on a worker thread
+	virtual bool canLoadOnThread(){ return true; }
 
   protected:
 	
-	virtual float interpolateValueForKeys(ofxTLKeyframe* start,ofxTLKeyframe* end, unsigned long long sampleTime);
-	virtual float evaluateKeyframeAtTime(ofxTLKeyframe* key, unsigned long long sampleTime, bool firstKey = false);
+	virtual float interpolateValueForKeys(ofxTLKeyframe* start,ofxTLKeyframe* end, unsigned long long sampleTime) const;
+	virtual float evaluateKeyframeAtTime(ofxTLKeyframe* key, unsigned long long sampleTime, bool firstKey = false) const;
+	//filling buffers, see the tolerance note in ofxTLLFO.cpp
+	virtual void interpolateValuesForKeys(ofxTLKeyframe* start, ofxTLKeyframe* end, double firstSampleTime, double sampleStep, int count, float* samples) const;
+	virtual void evaluateValuesForKey(ofxTLKeyframe* key, double firstSampleTime, double sampleStep, int count, float* samples) const;
+	virtual bool canSampleMappedKeys() const { return false; }
 
 	
 	virtual ofxTLKeyframe* keyframeAtScreenpoint(ofVec2f p);
@@ -104,8 +111,12 @@ class ofxTLLFO : public ofxTLKeyframes {
 	//load this keyframe out of xml, which is alraedy pushed to the right level
 	//only need to save custom properties that our subclass adds
 	virtual void restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore);
+	virtual void restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues);
 	//save custom properties into the xml
     virtual void storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore);
+	//same for the binary format
+	virtual void restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader);
+	virtual void storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer);
 
 	//responde to right clicks on keyframes
     virtual void selectedKeySecondaryClick(ofMouseEventArgs& args);
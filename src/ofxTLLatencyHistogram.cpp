@@ -0,0 +1,115 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "ofxTLLatencyHistogram.h"
+
+static const double bucketBounds[] = {10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000};
+static const int numBounds = sizeof(bucketBounds)/sizeof(double);
+
+ofxTLLatencyHistogram::ofxTLLatencyHistogram(){
+	reset();
+}
+
+void ofxTLLatencyHistogram::reset(){
+	bucketCounts.assign(numBounds+1, 0);
+	count = 0;
+	sum = 0;
+	minMicros = 0;
+	maxMicros = 0;
+}
+
+void ofxTLLatencyHistogram::add(double latencyMicros){
+	int bucket = upper_bound(bucketBounds, bucketBounds+numBounds, latencyMicros) - bucketBounds;
+	bucketCounts[bucket]++;
+	minMicros = count == 0 ? latencyMicros : MIN(minMicros, latencyMicros);
+	maxMicros = count == 0 ? latencyMicros : MAX(maxMicros, latencyMicros);
+	sum += latencyMicros;
+	count++;
+}
+
+unsigned long long ofxTLLatencyHistogram::getCount(){
+	return count;
+}
+
+double ofxTLLatencyHistogram::getMeanMicros(){
+	return count == 0 ? 0 : sum / count;
+}
+
+double ofxTLLatencyHistogram::getMinMicros(){
+	return minMicros;
+}
+
+double ofxTLLatencyHistogram::getMaxMicros(){
+	return maxMicros;
+}
+
+double ofxTLLatencyHistogram::getPercentileMicros(float percentile){
+	if(count == 0){
+		return 0;
+	}
+	unsigned long long target = ceil(ofClamp(percentile, 0, 1) * count);
+	unsigned long long seen = 0;
+	for(int i = 0; i < bucketCounts.size(); i++){
+		seen += bucketCounts[i];
+		if(seen >= target && seen > 0){
+			return MIN(getBucketUpperMicros(i), maxMicros);
+		}
+	}
+	return maxMicros;
+}
+
+int ofxTLLatencyHistogram::getNumBuckets(){
+	return bucketCounts.size();
+}
+
+double ofxTLLatencyHistogram::getBucketUpperMicros(int bucket){
+	return bucket < numBounds ? bucketBounds[bucket] : maxMicros;
+}
+
+unsigned long long ofxTLLatencyHistogram::getBucketCount(int bucket){
+	return bucketCounts[bucket];
+}
+
+string ofxTLLatencyHistogram::toString(){
+	stringstream report;
+	report << count << " samples, mean " << getMeanMicros() << "us, max " << maxMicros << "us, 99% under " << getPercentileMicros(.99) << "us" << endl;
+	for(int i = 0; i < bucketCounts.size(); i++){
+		if(i < numBounds){
+			report << "  < " << bucketBounds[i] << "us\t";
+		}
+		else{
+			report << " >= " << bucketBounds[numBounds-1] << "us\t";
+		}
+		report << bucketCounts[i] << "\t" << (count == 0 ? 0 : 100.0*bucketCounts[i]/count) << "%" << endl;
+	}
+	return report.str();
+}
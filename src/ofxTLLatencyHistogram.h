@@ -0,0 +1,67 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "ofMain.h"
+
+//Counts latencies into fixed buckets from 10us to 100ms, plus one for anything slower,
+//so the shape of the timing can be reported without keeping every sample
+class ofxTLLatencyHistogram {
+  public:
+	ofxTLLatencyHistogram();
+	
+	void reset();
+	void add(double latencyMicros);
+	
+	unsigned long long getCount();
+	double getMeanMicros();
+	double getMinMicros();
+	double getMaxMicros();
+	//the bucket bound that percentile (0-1) of the samples fall under, so an upper estimate
+	double getPercentileMicros(float percentile);
+	
+	int getNumBuckets();
+	//the last bucket has no upper bound and returns getMaxMicros()
+	double getBucketUpperMicros(int bucket);
+	unsigned long long getBucketCount(int bucket);
+	
+	//one line per bucket with its share of the samples, for logs and reports
+	string toString();
+	
+  protected:
+	vector<unsigned long long> bucketCounts;
+	unsigned long long count;
+	double sum;
+	double minMicros;
+	double maxMicros;
+};
@@ -0,0 +1,151 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "ofxTLMappedFile.h"
+
+#ifdef TARGET_WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+ofxTLMappedFile::ofxTLMappedFile()
+:	data(NULL),
+	length(0)
+#ifdef TARGET_WIN32
+	,fileHandle(NULL),
+	mappingHandle(NULL)
+#endif
+{
+	//
+}
+
+ofxTLMappedFile::~ofxTLMappedFile(){
+	close();
+}
+
+bool ofxTLMappedFile::open(string filePath){
+	close();
+	string absolutePath = ofToDataPath(filePath, true);
+	
+#ifdef TARGET_WIN32
+	HANDLE file = CreateFileA(absolutePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE){
+		ofLogError("ofxTLMappedFile::open") << "couldn't open " << absolutePath;
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0){
+		//empty files can't be mapped
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(mapping == NULL){
+		ofLogError("ofxTLMappedFile::open") << "couldn't map " << absolutePath;
+		CloseHandle(file);
+		return false;
+	}
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if(view == NULL){
+		ofLogError("ofxTLMappedFile::open") << "couldn't map " << absolutePath;
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	fileHandle = file;
+	mappingHandle = mapping;
+	data = (const char*)view;
+	length = fileSize.QuadPart;
+#else
+	int file = ::open(absolutePath.c_str(), O_RDONLY);
+	if(file == -1){
+		ofLogError("ofxTLMappedFile::open") << "couldn't open " << absolutePath;
+		return false;
+	}
+	struct stat fileInfo;
+	if(fstat(file, &fileInfo) == -1 || fileInfo.st_size == 0){
+		//empty files can't be mapped
+		::close(file);
+		return false;
+	}
+	void* view = mmap(NULL, fileInfo.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	//the mapping keeps its own reference to the file
+	::close(file);
+	if(view == MAP_FAILED){
+		ofLogError("ofxTLMappedFile::open") << "couldn't map " << absolutePath;
+		return false;
+	}
+	data = (const char*)view;
+	length = fileInfo.st_size;
+#endif
+	
+	path = filePath;
+	return true;
+}
+
+void ofxTLMappedFile::close(){
+	if(data == NULL){
+		return;
+	}
+#ifdef TARGET_WIN32
+	UnmapViewOfFile(data);
+	CloseHandle((HANDLE)mappingHandle);
+	CloseHandle((HANDLE)fileHandle);
+	mappingHandle = NULL;
+	fileHandle = NULL;
+#else
+	munmap((void*)data, length);
+#endif
+	data = NULL;
+	length = 0;
+	path = "";
+}
+
+bool ofxTLMappedFile::isOpen() const{
+	return data != NULL;
+}
+
+const char* ofxTLMappedFile::getData() const{
+	return data;
+}
+
+size_t ofxTLMappedFile::size() const{
+	return length;
+}
+
+string ofxTLMappedFile::getPath() const{
+	return path;
+}
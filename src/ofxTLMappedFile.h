@@ -0,0 +1,66 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "ofMain.h"
+
+//Read only view of a whole file through the operating system's virtual memory.
+//Opening is nearly free, pages are read from disk the first time they're touched
+//and can be dropped again by the system, so big files don't count against the process until they're used.
+class ofxTLMappedFile {
+  public:
+	ofxTLMappedFile();
+	~ofxTLMappedFile();
+	
+	//path is relative to the data folder
+	bool open(string path);
+	void close();
+	
+	bool isOpen() const;
+	const char* getData() const;
+	size_t size() const;
+	string getPath() const;
+	
+  protected:
+	//owns the mapping, not copyable
+	ofxTLMappedFile(const ofxTLMappedFile&);
+	ofxTLMappedFile& operator=(const ofxTLMappedFile&);
+	
+	const char* data;
+	size_t length;
+	string path;
+#ifdef TARGET_WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#endif
+};
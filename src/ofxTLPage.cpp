@@ -84,10 +84,17 @@ void ofxTLPage::setup(){
 
 //given a folder the page will look for xml files to load within that
 void ofxTLPage::loadTracksFromFolder(string folderPath){
+	setTracksFolder(folderPath);
+    for(int i = 0; i < headers.size(); i++){
+        tracks[headers[i]->name]->load();
+    }
+}
+
+//points every track at its file in the folder without loading it
+void ofxTLPage::setTracksFolder(string folderPath){
     for(int i = 0; i < headers.size(); i++){
 		string filename = folderPath + tracks[headers[i]->name]->getXMLFileName();
         tracks[headers[i]->name]->setXMLFileName(filename);
-        tracks[headers[i]->name]->load();
     }
 }
 
@@ -503,11 +510,12 @@ vector<ofxTLTrack*>& ofxTLPage::getTracks(){
 }
 
 ofxTLTrack* ofxTLPage::getTrack(string trackName){
-	if(tracks.find(trackName) == tracks.end()){
+	map<string, ofxTLTrack*>::iterator it = tracks.find(trackName);
+	if(it == tracks.end()){
 		ofLogError("ofxTLPage -- Couldn't find element named " + trackName + " on page " + name);
 		return NULL;
 	}
-	return tracks[trackName];
+	return it->second;
 }
 
 ofxTLTrackHeader* ofxTLPage::getTrackHeader(ofxTLTrack* track){
@@ -95,6 +95,7 @@ class ofxTLPage {
 
     //given a folder the page will look for xml files to load within that
 	void loadTracksFromFolder(string folderPath);
+	void setTracksFolder(string folderPath);
     void saveTracksToFolder(string folderPath);
 	
 	//this will swap out the xml file names that have been set to default based on the timeline name
@@ -0,0 +1,312 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "ofxTLSnapshot.h"
+
+#include "ofxTLAtomic.h"
+#include "ofxTLClock.h"
+#include "ofxTLKeyframes.h"
+#include "ofxTLSwitches.h"
+#include "ofxTLColorTrack.h"
+#include "ofxTLBangs.h"
+#include "ofxTLCameraTrack.h"
+
+ofxTLSnapshotLayout::ofxTLSnapshotLayout()
+:	references(1)
+{
+}
+
+void ofxTLSnapshotLayout::retain() const {
+	ofxTLAtomicIncrement(&references);
+}
+
+void ofxTLSnapshotLayout::release() const {
+	if(ofxTLAtomicDecrement(&references) == 0){
+		delete this;
+	}
+}
+
+ofxTLSnapshotLayout::Kind ofxTLSnapshotLayout::getTrackKind(ofxTLTrack* track){
+	//switches and colors are keyframe tracks too, so check for them first
+	if(dynamic_cast<ofxTLColorTrack*>(track) != NULL){
+		return COLOR;
+	}
+	if(dynamic_cast<ofxTLSwitches*>(track) != NULL){
+		return SWITCH;
+	}
+	if(dynamic_cast<ofxTLBangs*>(track) == NULL &&
+	   dynamic_cast<ofxTLCameraTrack*>(track) == NULL &&
+	   dynamic_cast<ofxTLKeyframes*>(track) != NULL)
+	{
+		return VALUE;
+	}
+	return NONE;
+}
+
+int ofxTLSnapshotLayout::getTrackIndex(const string& name) const {
+	for(int i = 0; i < names.size(); i++){
+		if(names[i] == name){
+			return i;
+		}
+	}
+	return -1;
+}
+
+ofxTLSnapshot::ofxTLSnapshot()
+:	sequence(0),
+	timestampNanos(0),
+	currentMillis(0),
+	isPlaying(false),
+	layout(NULL)
+{
+}
+
+ofxTLSnapshot::ofxTLSnapshot(const ofxTLSnapshot& other)
+:	sequence(other.sequence),
+	timestampNanos(other.timestampNanos),
+	currentMillis(other.currentMillis),
+	isPlaying(other.isPlaying),
+	layout(other.layout),
+	values(other.values)
+{
+	if(layout != NULL){
+		layout->retain();
+	}
+}
+
+ofxTLSnapshot& ofxTLSnapshot::operator=(const ofxTLSnapshot& other){
+	//take the new reference first in case both point at the same layout
+	if(other.layout != NULL){
+		other.layout->retain();
+	}
+	if(layout != NULL){
+		layout->release();
+	}
+	sequence = other.sequence;
+	timestampNanos = other.timestampNanos;
+	currentMillis = other.currentMillis;
+	isPlaying = other.isPlaying;
+	layout = other.layout;
+	values = other.values;
+	return *this;
+}
+
+ofxTLSnapshot::~ofxTLSnapshot(){
+	if(layout != NULL){
+		layout->release();
+	}
+}
+
+int ofxTLSnapshot::getNumTracks() const {
+	return values.size();
+}
+
+int ofxTLSnapshot::getTrackIndex(const string& name) const {
+	return layout != NULL ? layout->getTrackIndex(name) : -1;
+}
+
+float ofxTLSnapshot::getValue(int trackIndex) const {
+	return values[trackIndex].value;
+}
+
+bool ofxTLSnapshot::isOn(int trackIndex) const {
+	return values[trackIndex].on;
+}
+
+ofColor ofxTLSnapshot::getColor(int trackIndex) const {
+	return values[trackIndex].color;
+}
+
+ofxTLSnapshotBuffer::Slot::Slot()
+:	writeCount(0),
+	sequence(0),
+	timestampNanos(0),
+	currentMillis(0),
+	isPlaying(false)
+{
+}
+
+ofxTLSnapshotBuffer::Generation::Generation()
+:	layout(NULL),
+	newestSlot(0)
+{
+}
+
+ofxTLSnapshotBuffer::ofxTLSnapshotBuffer()
+:	current(NULL),
+	activeReaders(0),
+	numPublished(0)
+{
+}
+
+ofxTLSnapshotBuffer::~ofxTLSnapshotBuffer(){
+	for(int i = 0; i < retired.size(); i++){
+		retired[i]->layout->release();
+		delete retired[i];
+	}
+	if(current != NULL){
+		current->layout->release();
+		delete current;
+	}
+}
+
+ofxTLSnapshotBuffer::Generation* ofxTLSnapshotBuffer::createGeneration(const vector<ofxTLTrack*>& tracks){
+	Generation* generation = new Generation();
+	//starts with the generation's reference
+	generation->layout = new ofxTLSnapshotLayout();
+	ofxTLSnapshotLayout& layout = *generation->layout;
+	layout.tracks = tracks;
+	for(int i = 0; i < tracks.size(); i++){
+		layout.names.push_back(tracks[i]->getName());
+		layout.kinds.push_back(ofxTLSnapshotLayout::getTrackKind(tracks[i]));
+	}
+	
+	ofxTLTrackValue empty;
+	empty.value = 0;
+	empty.on = false;
+	empty.color = ofColor(0);
+	for(int i = 0; i < NUM_SLOTS; i++){
+		generation->slots[i].values.resize(tracks.size(), empty);
+	}
+	generation->cursors.resize(tracks.size());
+	return generation;
+}
+
+void ofxTLSnapshotBuffer::sample(Generation* generation, long currentMillis, vector<ofxTLTrackValue>& values){
+	const ofxTLSnapshotLayout& layout = *generation->layout;
+	for(int i = 0; i < layout.tracks.size(); i++){
+		switch(layout.kinds[i]){
+			case ofxTLSnapshotLayout::VALUE:
+				values[i].value = static_cast<ofxTLKeyframes*>(layout.tracks[i])->getValueAtTimeInMillis(currentMillis, &generation->cursors[i]);
+				break;
+			case ofxTLSnapshotLayout::SWITCH:
+				values[i].on = static_cast<ofxTLSwitches*>(layout.tracks[i])->isOnAtMillis(currentMillis);
+				break;
+			case ofxTLSnapshotLayout::COLOR:
+				values[i].color = static_cast<ofxTLColorTrack*>(layout.tracks[i])->getColorAtMillis(currentMillis, &generation->cursors[i]);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+void ofxTLSnapshotBuffer::freeRetiredGenerations(){
+	//readers count themselves in before loading current, so once current has been swapped
+	//and none are counted, none can be holding a generation retired before the swap
+	if(retired.empty() || ofxTLLoadAcquire(&activeReaders) != 0){
+		return;
+	}
+	for(int i = 0; i < retired.size(); i++){
+		retired[i]->layout->tracks.clear();
+		retired[i]->layout->release();
+		delete retired[i];
+	}
+	retired.clear();
+}
+
+void ofxTLSnapshotBuffer::publish(const vector<ofxTLTrack*>& tracks, long currentMillis, bool isPlaying){
+	Generation* generation = current;
+	int slotIndex;
+	bool newGeneration = generation == NULL || generation->layout->tracks != tracks;
+	if(newGeneration){
+		//nobody can see this one yet, so fill its first slot before swapping it in
+		generation = createGeneration(tracks);
+		slotIndex = 0;
+	}
+	else{
+		//never the newest, which is the one readers are heading for
+		slotIndex = (generation->newestSlot + 1) % NUM_SLOTS;
+	}
+	
+	Slot& slot = generation->slots[slotIndex];
+	ofxTLStoreRelease(&slot.writeCount, slot.writeCount + 1);
+	ofxTLMemoryBarrier();
+	slot.sequence = ++numPublished;
+	slot.timestampNanos = ofxTLClock::getNanos();
+	slot.currentMillis = currentMillis;
+	slot.isPlaying = isPlaying;
+	sample(generation, currentMillis, slot.values);
+	ofxTLStoreRelease(&slot.writeCount, slot.writeCount + 1);
+	
+	ofxTLStoreRelease(&generation->newestSlot, slotIndex);
+	if(newGeneration){
+		Generation* previous = current;
+		ofxTLStoreRelease(&current, generation);
+		if(previous != NULL){
+			retired.push_back(previous);
+		}
+	}
+	freeRetiredGenerations();
+}
+
+bool ofxTLSnapshotBuffer::read(ofxTLSnapshot& snapshot){
+	ofxTLAtomicIncrement(&activeReaders);
+	Generation* generation = ofxTLLoadAcquire(&current);
+	if(generation == NULL){
+		ofxTLAtomicDecrement(&activeReaders);
+		return false;
+	}
+	
+	while(true){
+		Slot& slot = generation->slots[ofxTLLoadAcquire(&generation->newestSlot)];
+		unsigned int writeCount = ofxTLLoadAcquire(&slot.writeCount);
+		if(writeCount % 2 == 1){
+			//lapped by the writer, the newest slot will have moved on
+			continue;
+		}
+		snapshot.sequence = slot.sequence;
+		snapshot.timestampNanos = slot.timestampNanos;
+		snapshot.currentMillis = slot.currentMillis;
+		snapshot.isPlaying = slot.isPlaying;
+		//the slot's vector is never resized, only its elements are written
+		snapshot.values.assign(slot.values.begin(), slot.values.end());
+		ofxTLMemoryBarrier();
+		if(slot.writeCount == writeCount){
+			break;
+		}
+	}
+	//the generation can't be freed while this reader is counted, so its layout is still alive to retain
+	if(snapshot.layout != generation->layout){
+		generation->layout->retain();
+		if(snapshot.layout != NULL){
+			snapshot.layout->release();
+		}
+		snapshot.layout = generation->layout;
+	}
+	ofxTLAtomicDecrement(&activeReaders);
+	return true;
+}
+
+unsigned long long ofxTLSnapshotBuffer::getNumPublished(){
+	return numPublished;
+}
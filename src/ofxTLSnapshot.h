@@ -0,0 +1,166 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxTLKeyframes.h"
+
+class ofxTLTrack;
+
+//one track's value at the moment the snapshot was taken
+//only the field matching the track's kind means anything
+typedef struct {
+	float value;
+	bool on;
+	ofColor color;
+} ofxTLTrackValue;
+
+//the names and kinds of the tracks a snapshot was taken from, in snapshot order
+//names and kinds are never changed after they're published. a layout lives as long as
+//the buffer's generation or any snapshot still points at it, so indices looked up in it
+//are good for as long as a snapshot holding it is kept.
+//tracks is emptied once the tracks have changed and no reader is copying from the old layout
+class ofxTLSnapshotLayout {
+  public:
+	enum Kind {
+		NONE, //bangs, flags, cameras and media tracks have no single value
+		VALUE,
+		SWITCH,
+		COLOR
+	};
+	
+	ofxTLSnapshotLayout();
+	
+	//which single value a track has, if any. the baker sorts its columns the same way
+	static Kind getTrackKind(ofxTLTrack* track);
+	
+	//-1 if there's no track by that name. look indices up once and keep them
+	int getTrackIndex(const string& name) const;
+	
+	//the generation and every snapshot pointing at the layout hold a reference,
+	//the last one to let go deletes it. safe from any thread
+	void retain() const;
+	void release() const;
+	
+	vector<ofxTLTrack*> tracks;
+	vector<string> names;
+	vector<Kind> kinds;
+	
+  protected:
+	mutable volatile unsigned int references;
+};
+
+//a reader's copy of the values every track had on one tick
+class ofxTLSnapshot {
+  public:
+	ofxTLSnapshot();
+	ofxTLSnapshot(const ofxTLSnapshot& other);
+	ofxTLSnapshot& operator=(const ofxTLSnapshot& other);
+	~ofxTLSnapshot();
+	
+	int getNumTracks() const;
+	//-1 if there's no track by that name
+	int getTrackIndex(const string& name) const;
+	
+	float getValue(int trackIndex) const;
+	bool isOn(int trackIndex) const;
+	ofColor getColor(int trackIndex) const;
+	
+	//counts up by one every time a snapshot is published
+	unsigned long long sequence;
+	//clock time the values were sampled at, see ofxTLClock::getNanos()
+	unsigned long long timestampNanos;
+	long currentMillis;
+	bool isPlaying;
+	
+	//stays the same object from snapshot to snapshot until tracks are added or removed,
+	//so comparing it is enough to know whether cached indices are still good.
+	//the snapshot keeps it alive, only compare against a layout a kept snapshot still holds
+	const ofxTLSnapshotLayout* layout;
+	vector<ofxTLTrackValue> values;
+};
+
+//publishes snapshots from the timeline's update thread and hands them to readers on any thread
+//three slots are written round robin, never the newest one, each with a sequence count that's odd
+//while it's being written. readers copy the newest slot and check the count didn't move,
+//trying again in the rare case the writer lapped them, so neither side ever waits on a lock
+//when the tracks change a new set of slots is published with a pointer swap. the old slots
+//are freed on the first publish that finds no reader inside read(), and their layout
+//along with them unless a snapshot still holds it
+class ofxTLSnapshotBuffer {
+  public:
+	ofxTLSnapshotBuffer();
+	~ofxTLSnapshotBuffer();
+	
+	//samples every track and publishes the result. only call from one thread at a time
+	void publish(const vector<ofxTLTrack*>& tracks, long currentMillis, bool isPlaying);
+	//copies the newest snapshot, false if nothing has been published yet. safe from any thread
+	bool read(ofxTLSnapshot& snapshot);
+	unsigned long long getNumPublished();
+	
+  protected:
+	static const int NUM_SLOTS = 3;
+	
+	class Slot {
+	  public:
+		Slot();
+		volatile unsigned int writeCount;
+		unsigned long long sequence;
+		unsigned long long timestampNanos;
+		long currentMillis;
+		bool isPlaying;
+		vector<ofxTLTrackValue> values;
+	};
+	
+	class Generation {
+	  public:
+		Generation();
+		ofxTLSnapshotLayout* layout;
+		Slot slots[NUM_SLOTS];
+		volatile int newestSlot;
+		//one per track, only touched by the writer
+		vector<ofxTLKeyframeCursor> cursors;
+	};
+	
+	Generation* createGeneration(const vector<ofxTLTrack*>& tracks);
+	//reads every track through its const sampling path, so publishing never writes track state
+	void sample(Generation* generation, long currentMillis, vector<ofxTLTrackValue>& values);
+	//frees the generations swapped out so far if no reader can still be copying them
+	void freeRetiredGenerations();
+	
+	Generation* volatile current;
+	vector<Generation*> retired;
+	//readers inside read(), the writer frees retired generations only when it's zero
+	volatile unsigned int activeReaders;
+	unsigned long long numPublished;
+};
@@ -37,6 +37,8 @@
 ofxTLSwitches::ofxTLSwitches(){
 	placingSwitch = NULL;
     lastTimelinePoint = 0;
+	includeLastPoint = true;
+    switchIndexValid = false;
     enteringText = false;
 	clickedTextField = NULL;
 }
@@ -45,39 +47,98 @@ ofxTLSwitches::~ofxTLSwitches(){
     
 }
 
+static bool switchStartsEarlier(ofxTLSwitch* a, ofxTLSwitch* b){
+	return a->timeRange.min < b->timeRange.min;
+}
+
+static bool switchEndsEarlier(ofxTLSwitch* a, ofxTLSwitch* b){
+	return a->timeRange.max < b->timeRange.max;
+}
+
+//switches that overlap or touch make one span
+static void mergeOnSpans(const vector<ofxTLSwitch*>& switchesByStart, vector<ofxTLSwitchSpan>& spans){
+	spans.clear();
+	for(int i = 0; i < switchesByStart.size(); i++){
+		ofxTLSwitch* switchKey = switchesByStart[i];
+		if(!spans.empty() && switchKey->timeRange.min <= spans.back().end){
+			if(switchKey->timeRange.max > spans.back().end){
+				spans.back().end = switchKey->timeRange.max;
+				spans.back().endKey = switchKey;
+			}
+			continue;
+		}
+		ofxTLSwitchSpan span = { switchKey->timeRange.min, switchKey->timeRange.max, switchKey, switchKey };
+		spans.push_back(span);
+	}
+}
+
 void ofxTLSwitches::update(){
     long thisTimelinePoint = currentTrackTime();
-    for(int i = 0; i < keyframes.size(); i++){
-        ofxTLSwitch* switchKey = (ofxTLSwitch*)keyframes[i];
-        
-        // switch turns on
-        if(timeline->getInOutRangeMillis().contains(switchKey->time) &&
-           lastTimelinePoint <= switchKey->time &&
-           thisTimelinePoint >= switchKey->time &&
-           thisTimelinePoint != lastTimelinePoint)
-        {
-            switchStateChanged(keyframes[i]);
-        }
-        
-        // switch turns off
-        if(timeline->getInOutRangeMillis().contains(switchKey->timeRange.max) &&
-           lastTimelinePoint <= switchKey->timeRange.max &&
-           thisTimelinePoint >= switchKey->timeRange.max &&
-           thisTimelinePoint != lastTimelinePoint)
-        {
-            switchStateChanged(keyframes[i]);
-        }
-    }
+	refreshSwitchIndex();
+	if(thisTimelinePoint > lastTimelinePoint){
+		//an edge right on the last point was sent by the last update, unless playback has just started there
+		unsigned long long crossedStart = includeLastPoint ? lastTimelinePoint : lastTimelinePoint+1;
+		unsigned long long crossedEnd = thisTimelinePoint;
+		ofLongRange inOut = timeline->getInOutRangeMillis();
+		//the starts and the ends inside the window, sent together in time order
+		int on = lower_bound(switchStarts.begin(), switchStarts.end(), crossedStart) - switchStarts.begin();
+		int lastOn = upper_bound(switchStarts.begin(), switchStarts.end(), crossedEnd) - switchStarts.begin();
+		int off = lower_bound(switchEnds.begin(), switchEnds.end(), crossedStart) - switchEnds.begin();
+		int lastOff = upper_bound(switchEnds.begin(), switchEnds.end(), crossedEnd) - switchEnds.begin();
+		while(on < lastOn || off < lastOff){
+			//on the same millisecond a switch that was already on turns off before the next turns on,
+			//but one with no length has to turn on first
+			bool turnsOff = off < lastOff &&
+				(on == lastOn ||
+				 switchEnds[off] < switchStarts[on] ||
+				 (switchEnds[off] == switchStarts[on] && switchesByEnd[off]->timeRange.min < switchEnds[off]));
+			if(turnsOff){
+				ofxTLSwitch* switchKey = switchesByEnd[off++];
+				if(inOut.contains(switchKey->timeRange.max)){
+					switchStateChanged(switchKey, switchKey->timeRange.max, false);
+				}
+			}
+			else{
+				ofxTLSwitch* switchKey = indexedSwitches[on++];
+				if(inOut.contains(switchKey->time)){
+					switchStateChanged(switchKey, switchKey->time, true);
+				}
+			}
+		}
+		includeLastPoint = false;
+	}
+	else if(thisTimelinePoint < lastTimelinePoint){
+		includeLastPoint = true;
+	}
     lastTimelinePoint = thisTimelinePoint;
 }
 
-void ofxTLSwitches::switchStateChanged(ofxTLKeyframe* key){
+void ofxTLSwitches::playbackStarted(ofxTLPlaybackEventArgs& args){
+	ofxTLTrack::playbackStarted(args);
+	lastTimelinePoint = currentTrackTime();
+	includeLastPoint = true;
+}
+
+void ofxTLSwitches::playheadJumped(){
+	lastTimelinePoint = currentTrackTime();
+	includeLastPoint = true;
+}
+
+void ofxTLSwitches::playbackLooped(ofxTLPlaybackEventArgs& args){
+	lastTimelinePoint = 0;
+	includeLastPoint = true;
+}
+
+void ofxTLSwitches::switchStateChanged(ofxTLKeyframe* key, unsigned long long edgeMillis, bool on){
     ofxTLSwitchEventArgs args;
     args.sender = timeline;
     args.track = this;
-    args.on = isOn();
+	//from the edge rather than isOn(), which is wrong when one update crosses both ends of a switch
+    args.on = on;
     args.switchName = ((ofxTLSwitch*)key)->textField.text;
-    ofNotifyEvent(events().switched, args);
+	args.currentMillis = currentTrackTime();
+	args.switchMillis = edgeMillis;
+	timeline->sendSwitchEvent(args);
 }
 
 void ofxTLSwitches::draw(){
@@ -191,39 +252,146 @@ void ofxTLSwitches::draw(){
     ofPopStyle();
 }
 
-bool ofxTLSwitches::isOnAtMillis(long millis){
-    for(int i = 0; i < keyframes.size(); i++){
-        ofxTLSwitch* switchKey = (ofxTLSwitch*)keyframes[i];
-        if(switchKey->timeRange.min > millis){
-            break;
-        }
-        if(switchKey->timeRange.contains(millis)){
-            return true;
-        }
-    }
-    return false;    
+bool ofxTLSwitches::isOnAtMillis(long millis) const{
+	if(!switchIndexValid){
+		return findSwitchAtMillis(millis) != NULL;
+	}
+    return findSpanAtMillis(millis) != -1;
 }
 
 bool ofxTLSwitches::isOn(){
+	refreshSwitchIndex();
 	return isOnAtMillis(currentTrackTime());
 }
 
 bool ofxTLSwitches::isOnAtPercent(float percent){
+	refreshSwitchIndex();
     unsigned long long millis = percent*timeline->getDurationInMilliseconds();
     return isOnAtMillis(millis);
 }
 
-ofxTLSwitch* ofxTLSwitches::getActiveSwitchAtMillis(long millis){
-    for(int i = 0; i < keyframes.size(); i++){
-        ofxTLSwitch* switchKey = (ofxTLSwitch*)keyframes[i];
-        if(switchKey->timeRange.min > millis){
-            break;
-        }
-        if(switchKey->timeRange.contains(millis)){
-            return switchKey;
-        }
-    }
-    return NULL;
+ofxTLSwitch* ofxTLSwitches::getActiveSwitchAtMillis(long millis) const{
+    return findSwitchAtMillis(millis);
+}
+
+ofxTLSwitch* ofxTLSwitches::findSwitchAtMillis(long millis) const{
+	if(!switchIndexValid){
+		for(int i = 0; i < keyframes.size(); i++){
+			ofxTLSwitch* switchKey = (ofxTLSwitch*)keyframes[i];
+			if(switchKey->timeRange.min > millis){
+				break;
+			}
+			if(switchKey->timeRange.contains(millis)){
+				return switchKey;
+			}
+		}
+		return NULL;
+	}
+	
+	int span = findSpanAtMillis(millis);
+	if(span == -1){
+		return NULL;
+	}
+	//something in the span contains millis, so walking back from the last start before it
+	//stops at the first switch that does, and never leaves the span
+	int i = upper_bound(switchStarts.begin(), switchStarts.end(), (unsigned long long)millis) - switchStarts.begin() - 1;
+	for(; i >= 0; i--){
+		if(indexedSwitches[i]->timeRange.max >= millis){
+			return indexedSwitches[i];
+		}
+	}
+	return NULL;
+}
+
+int ofxTLSwitches::findSpanAtMillis(long millis) const{
+	if(millis < 0){
+		return -1;
+	}
+	int span = lower_bound(onSpanEnds.begin(), onSpanEnds.end(), (unsigned long long)millis) - onSpanEnds.begin();
+	if(span == onSpans.size() || onSpans[span].start > (unsigned long long)millis){
+		return -1;
+	}
+	return span;
+}
+
+void ofxTLSwitches::getTransitionsInRange(unsigned long long startMillis, unsigned long long endMillis, vector<ofxTLSwitchTransition>& transitions) const{
+	transitions.clear();
+	vector<ofxTLSwitchSpan> mergedSpans;
+	const vector<ofxTLSwitchSpan>* spans = &onSpans;
+	int first = 0;
+	if(switchIndexValid){
+		first = lower_bound(onSpanEnds.begin(), onSpanEnds.end(), startMillis) - onSpanEnds.begin();
+	}
+	else{
+		vector<ofxTLSwitch*> sortedSwitches;
+		for(int i = 0; i < keyframes.size(); i++){
+			sortedSwitches.push_back((ofxTLSwitch*)keyframes[i]);
+		}
+		stable_sort(sortedSwitches.begin(), sortedSwitches.end(), switchStartsEarlier);
+		mergeOnSpans(sortedSwitches, mergedSpans);
+		spans = &mergedSpans;
+	}
+	
+	//each span's ends that land in the range
+	for(int i = first; i < spans->size() && (*spans)[i].start <= endMillis; i++){
+		const ofxTLSwitchSpan& span = (*spans)[i];
+		if(span.end < startMillis){
+			continue;
+		}
+		if(span.start >= startMillis){
+			ofxTLSwitchTransition on = { span.start, true, span.startKey };
+			transitions.push_back(on);
+		}
+		if(span.end <= endMillis){
+			ofxTLSwitchTransition off = { span.end, false, span.endKey };
+			transitions.push_back(off);
+		}
+	}
+}
+
+void ofxTLSwitches::updateKeyframeColumns(){
+	ofxTLKeyframes::updateKeyframeColumns();
+	
+	indexedSwitches.resize(keyframes.size());
+	bool sorted = true;
+	for(int i = 0; i < keyframes.size(); i++){
+		indexedSwitches[i] = (ofxTLSwitch*)keyframes[i];
+		if(i > 0 && indexedSwitches[i]->timeRange.min < indexedSwitches[i-1]->timeRange.min){
+			sorted = false;
+		}
+	}
+	//dragging a start can take it past the next switch's before the keys are sorted again
+	if(!sorted){
+		stable_sort(indexedSwitches.begin(), indexedSwitches.end(), switchStartsEarlier);
+	}
+	
+	switchesByEnd = indexedSwitches;
+	stable_sort(switchesByEnd.begin(), switchesByEnd.end(), switchEndsEarlier);
+	switchStarts.resize(indexedSwitches.size());
+	switchEnds.resize(indexedSwitches.size());
+	for(int i = 0; i < indexedSwitches.size(); i++){
+		switchStarts[i] = indexedSwitches[i]->timeRange.min;
+		switchEnds[i] = switchesByEnd[i]->timeRange.max;
+	}
+	
+	mergeOnSpans(indexedSwitches, onSpans);
+	onSpanEnds.resize(onSpans.size());
+	for(int i = 0; i < onSpans.size(); i++){
+		onSpanEnds[i] = onSpans[i].end;
+	}
+	switchIndexValid = true;
+}
+
+//a new switch takes its range from the mouse rather than the key time, so it can land anywhere in the index
+//switches are only added by hand, one at a time, so rebuilding it is cheap enough
+void ofxTLSwitches::keyframeAppended(ofxTLKeyframe* key){
+	updateKeyframeColumns();
+}
+
+void ofxTLSwitches::refreshSwitchIndex(){
+	if(!switchIndexValid){
+		updateKeyframeColumns();
+	}
 }
 
 bool ofxTLSwitches::mousePressed(ofMouseEventArgs& args, long millis){
@@ -417,6 +585,7 @@ void ofxTLSwitches::mouseMoved(ofMouseEventArgs& args, long millis){
     endHover = startHover = false;
     if(hover && placingSwitch != NULL){
 		placingSwitch->timeRange.max = millis;
+		switchIndexValid = false;
 		return;
 	}
 	
@@ -490,6 +659,7 @@ void ofxTLSwitches::updateTimeRanges(){
     }
 	
     //TODO: no overlaps!!
+	updateKeyframeColumns();
 }
 
 void ofxTLSwitches::mouseReleased(ofMouseEventArgs& args, long millis){
@@ -567,7 +737,9 @@ int ofxTLSwitches::getSelectedItemCount(){
 }
 
 ofxTLKeyframe* ofxTLSwitches::newKeyframe(){
-    ofxTLSwitch* switchKey = new ofxTLSwitch();
+    ofxTLSwitch* switchKey = createKeyframe<ofxTLSwitch>();
+	//its range isn't known until it's restored or placed
+	switchIndexValid = false;
     switchKey->textField.setFont(timeline->getFont());
 
     //in the case of a click, start at the mouse positiion
@@ -603,6 +775,21 @@ void ofxTLSwitches::restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore
 	placingSwitch = NULL;
 }
 
+void ofxTLSwitches::restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues){
+    ofxTLSwitch* switchKey = (ofxTLSwitch*)key;
+    switchKey->textField.text = keyValues.getValue("switchName", "");
+    switchKey->timeRange.min = switchKey->time;
+    string timecode = keyValues.getValue("max", "00:00:00:000");
+    if(timecode.find(":") == string::npos){
+        switchKey->timeRange.max = ofToFloat(timecode) * timeline->getDurationInMilliseconds(); //Legacy max of 0-1
+    }
+    else{
+		switchKey->timeRange.max = timeline->getTimecode().millisForTimecode(timecode);
+    }
+    switchKey->startSelected = switchKey->endSelected = false;
+	placingSwitch = NULL;
+}
+
 void ofxTLSwitches::storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore){
     //push the time range into X/Y
     ofxTLSwitch* switchKey = (ofxTLSwitch* )key;
@@ -611,7 +798,24 @@ void ofxTLSwitches::storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore){
 	xmlStore.addValue("max", timeline->getTimecode().timecodeForMillis(switchKey->timeRange.max));
 }
 
+void ofxTLSwitches::restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader){
+    ofxTLSwitch* switchKey = (ofxTLSwitch*)key;
+    switchKey->textField.text = reader.readString();
+    switchKey->timeRange.min = switchKey->time;
+    switchKey->timeRange.max = reader.readUInt64();
+    switchKey->startSelected = switchKey->endSelected = false;
+	placingSwitch = NULL;
+}
+
+void ofxTLSwitches::storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer){
+    ofxTLSwitch* switchKey = (ofxTLSwitch* )key;
+    writer.writeString(switchKey->textField.text);
+    switchKey->time = switchKey->timeRange.min;
+    writer.writeUInt64(switchKey->timeRange.max);
+}
+
 void ofxTLSwitches::willDeleteKeyframe(ofxTLKeyframe* keyframe){
+	switchIndexValid = false;
 	ofxTLSwitch* switchKey = (ofxTLSwitch* )keyframe;
 	if(switchKey->textField.getIsEditing()){
 		timeline->dismissedModalContent();
@@ -50,6 +50,21 @@ class ofxTLSwitch : public ofxTLKeyframe {
     ofRectangle textFieldDisplay;
 };
 
+//a point where a switch track turns on or off
+typedef struct {
+	unsigned long long millis;
+	bool on;
+	ofxTLSwitch* key; //the switch starting or ending there
+} ofxTLSwitchTransition;
+
+//overlapping switches merged into one stretch of time the track is on
+typedef struct {
+	unsigned long long start;
+	unsigned long long end;
+	ofxTLSwitch* startKey;
+	ofxTLSwitch* endKey; //the one reaching furthest
+} ofxTLSwitchSpan;
+
 class ofxTLSwitches : public ofxTLKeyframes {
   public:
 	ofxTLSwitches();
@@ -58,10 +73,13 @@ class ofxTLSwitches : public ofxTLKeyframes {
     virtual void draw();
 
 	virtual bool isOn();
-    virtual bool isOnAtMillis(long millis);
+    virtual bool isOnAtMillis(long millis) const; //thread safe
     virtual bool isOnAtPercent(float percent);
     
-    ofxTLSwitch* getActiveSwitchAtMillis(long millis);
+    ofxTLSwitch* getActiveSwitchAtMillis(long millis) const;
+    //every point the track turns on or off from startMillis to endMillis, both included, in time order
+    //overlapping switches count as one long one. thread safe, for schedulers that look ahead
+    void getTransitionsInRange(unsigned long long startMillis, unsigned long long endMillis, vector<ofxTLSwitchTransition>& transitions) const;
     
     virtual bool mousePressed(ofMouseEventArgs& args, long millis);
     virtual void mouseDragged(ofMouseEventArgs& args, long millis);
@@ -76,16 +94,25 @@ class ofxTLSwitches : public ofxTLKeyframes {
     virtual void unselectAll();
     
     virtual string getTrackType();
+    virtual bool supportsUndoDeltas(){ return false; }
     virtual void pasteSent(string pasteboard);
+	virtual void playbackStarted(ofxTLPlaybackEventArgs& args);
+	virtual void playbackLooped(ofxTLPlaybackEventArgs& args);
+    virtual void playheadJumped();
 	
   protected:
     virtual void update();
-    virtual void switchStateChanged(ofxTLKeyframe* key);
+    virtual void switchStateChanged(ofxTLKeyframe* key, unsigned long long edgeMillis, bool on);
     virtual void willDeleteKeyframe(ofxTLKeyframe* keyframe);
+	//switch ranges are kept on the keyframe objects
+	virtual bool canSampleMappedKeys() const { return false; }
     
     virtual ofxTLKeyframe* newKeyframe();
     virtual void restoreKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore);
+	virtual void restoreKeyframeFromXMLValues(ofxTLKeyframe* key, ofxTLXmlKeyReader& keyValues);
 	virtual void storeKeyframe(ofxTLKeyframe* key, ofxXmlSettings& xmlStore);
+	virtual void restoreKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryReader& reader);
+	virtual void storeKeyframeBinary(ofxTLKeyframe* key, ofxTLBinaryWriter& writer);
 	virtual ofxTLKeyframe* keyframeAtScreenpoint(ofVec2f p);
     virtual void updateEdgeDragOffsets(long clickMillis);
 	virtual int getSelectedItemCount();
@@ -94,7 +121,25 @@ class ofxTLSwitches : public ofxTLKeyframes {
 	//pushes any edits from keyframes superclass into the switches system
 	virtual void updateTimeRanges();
 	
+	//the switches sorted by start and again by end, so the edges an update crosses are two binary searches,
+	//and merged into the spans the track is on, so point and range queries are one
+	//rebuilt with the key columns. until then queries scan the keys, or rebuild it where they're allowed to
+	virtual void updateKeyframeColumns();
+	virtual void keyframeAppended(ofxTLKeyframe* key);
+	void refreshSwitchIndex();
+	ofxTLSwitch* findSwitchAtMillis(long millis) const;
+	//the span containing millis, -1 if the track is off there
+	int findSpanAtMillis(long millis) const;
+	vector<ofxTLSwitch*> indexedSwitches;
+	vector<unsigned long long> switchStarts;
+	vector<ofxTLSwitch*> switchesByEnd;
+	vector<unsigned long long> switchEnds;
+	vector<ofxTLSwitchSpan> onSpans;
+	vector<unsigned long long> onSpanEnds;
+	bool switchIndexValid;
+	
     long lastTimelinePoint;
+	bool includeLastPoint; //set when playback starts or jumps, so an edge right on lastTimelinePoint is sent
     bool startHover;
     bool endHover;
     ofxTLSwitch* placingSwitch;
@@ -32,6 +32,7 @@
 
 #include "ofxTLTrack.h"
 #include "ofxTimeline.h"
+#include "ofxTLClock.h"
 
 ofxTLTrack::ofxTLTrack()
 :	xmlFileName(""),
@@ -151,7 +152,8 @@ void ofxTLTrack::_draw(){
 
 unsigned long long ofxTLTrack::currentTrackTime(){
 	if(isPlaying){
-		currentTime = timeline->getTimer().getAppTimeMillis() - playbackStartTime;
+		//solo playback runs on the same clock as the timeline's own
+		currentTime = ofxTLClock::getNanos() / 1000000 - playbackStartTime;
 		checkLoop();
 		return currentTime;
 		//return timeline->getInTimeInMillis() + (timeline->getTimer().getAppTimeMillis() - playbackStartTime) % timeline->getInOutRangeMillis().span() ;
@@ -164,7 +166,7 @@ unsigned long long ofxTLTrack::currentTrackTime(){
 void ofxTLTrack::checkLoop(){
 	if(currentTime < timeline->getInTimeInMillis()){
         currentTime = timeline->getInTimeInMillis();
-        playbackStartTime = timeline->getTimer().getAppTimeSeconds() - currentTime;
+        playbackStartTime = ofxTLClock::getNanos() / 1000000 - currentTime;
 //        playbackStartFrame = ofGetFrameNum() - timecode.frameForSeconds(currentTime);
     }
     
@@ -193,7 +195,7 @@ void ofxTLTrack::play(){
 	if(!isPlaying && !timeline->getIsPlaying()){
 		isPlaying = true;
 		currentTime = ofClamp(timeline->getCurrentTimeMillis(), timeline->getInTimeInMillis(), timeline->getOutTimeInMillis());
-		playbackStartTime = timeline->getTimer().getAppTimeMillis() - currentTime;
+		playbackStartTime = ofxTLClock::getNanos() / 1000000 - currentTime;
 		checkLoop();
 	}
 }
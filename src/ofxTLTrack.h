@@ -37,6 +37,7 @@
 #include "ofxTween.h"
 #include "ofRange.h"
 #include "ofxTLEvents.h"
+#include "ofxTLUndoDelta.h"
 #include <set>
 #include <climits>
 
@@ -103,6 +104,9 @@ class ofxTLTrack
     virtual void playbackStarted(ofxTLPlaybackEventArgs& args);
 	virtual void playbackLooped(ofxTLPlaybackEventArgs& args){};
 	virtual void playbackEnded(ofxTLPlaybackEventArgs& args){};
+	//the timeline moved the playhead without playing through the time in between, like when an offline render starts,
+	//so tracks that send events as keys are crossed should carry on from the new time without sending any
+	virtual void playheadJumped(){};
 
 	virtual void keyPressed(ofKeyEventArgs& args){};
 	virtual void nudgeBy(ofVec2f nudgePercent){};
@@ -143,6 +147,12 @@ class ofxTLTrack
     //undo
     virtual string getXMLRepresentation(){return "";};
     virtual void loadFromXMLRepresentation(string rep){};
+	//tracks that return true record their edits between beginUndoDelta() and endUndoDelta()
+	//and are never asked for their xml representation by the undo stack
+	virtual bool supportsUndoDeltas(){ return false; };
+	virtual void beginUndoDelta(){};
+	//the changes since beginUndoDelta(), or NULL if there weren't any. the caller deletes it
+	virtual ofxTLUndoDelta* endUndoDelta(){ return NULL; };
 
 	//zoom events
 	virtual void zoomStarted(ofxTLZoomEventArgs& args);
@@ -154,6 +164,13 @@ class ofxTLTrack
 	virtual void save(){};
 	virtual void load(){};
 	virtual void clear(){};
+	
+	//parallel loading, see ofxTimeline::setLoadTracksInParallel()
+	//tracks that can read their files without GL, events or other tracks return true and split
+	//load() into loadOnThread(), run on a worker thread, and finishLoad(), run on the main thread once every track is loaded
+	virtual bool canLoadOnThread(){ return false; };
+	virtual void loadOnThread(){};
+	virtual void finishLoad(){};
 
 	//add any points (in screenspace x) that should be snapped to
 	virtual void getSnappingPoints(std::set<unsigned long long>& points){};
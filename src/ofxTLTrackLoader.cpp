@@ -0,0 +1,114 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "ofxTLTrackLoader.h"
+#include "ofxTLTrack.h"
+
+ofxTLTrackLoader::ofxTLTrackLoader()
+:	nextTrack(0),
+	numLoaded(0)
+{
+	//
+}
+
+ofxTLTrackLoader::~ofxTLTrackLoader(){
+	waitForTracks();
+}
+
+void ofxTLTrackLoader::start(const vector<ofxTLTrack*>& tracksToLoad, int numThreads){
+	waitForTracks();
+	tracks = tracksToLoad;
+	nextTrack = 0;
+	numLoaded = 0;
+	
+	numThreads = MIN(numThreads, (int)tracks.size());
+	for(int i = 0; i < numThreads; i++){
+		Worker* worker = new Worker();
+		worker->loader = this;
+		workers.push_back(worker);
+		worker->startThread(false, false);
+	}
+}
+
+void ofxTLTrackLoader::waitForTracks(){
+	for(int i = 0; i < workers.size(); i++){
+		workers[i]->waitForThread(false);
+		delete workers[i];
+	}
+	workers.clear();
+}
+
+int ofxTLTrackLoader::getNumLoaded(){
+	queueLock.lock();
+	int loaded = numLoaded;
+	queueLock.unlock();
+	return loaded;
+}
+
+int ofxTLTrackLoader::waitForProgress(int loaded){
+	queueLock.lock();
+	while(numLoaded <= loaded && numLoaded < tracks.size()){
+		progress.wait(queueLock);
+	}
+	loaded = numLoaded;
+	queueLock.unlock();
+	return loaded;
+}
+
+int ofxTLTrackLoader::getNumTracks(){
+	return tracks.size();
+}
+
+ofxTLTrack* ofxTLTrackLoader::takeNextTrack(){
+	ofxTLTrack* track = NULL;
+	queueLock.lock();
+	if(nextTrack < tracks.size()){
+		track = tracks[nextTrack++];
+	}
+	queueLock.unlock();
+	return track;
+}
+
+void ofxTLTrackLoader::trackLoaded(){
+	queueLock.lock();
+	numLoaded++;
+	progress.broadcast();
+	queueLock.unlock();
+}
+
+void ofxTLTrackLoader::Worker::threadedFunction(){
+	ofxTLTrack* track;
+	while((track = loader->takeNextTrack()) != NULL){
+		track->loadOnThread();
+		loader->trackLoaded();
+	}
+}
@@ -0,0 +1,76 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "Poco/Condition.h"
+
+class ofxTLTrack;
+
+//Runs loadOnThread() for a list of tracks across a few worker threads.
+//Each worker takes the next unloaded track until none are left,
+//so one big track doesn't hold up the rest.
+class ofxTLTrackLoader {
+  public:
+	ofxTLTrackLoader();
+	~ofxTLTrackLoader();
+	
+	//starts the workers and returns right away
+	void start(const vector<ofxTLTrack*>& tracks, int numThreads);
+	//blocks until every track is loaded
+	void waitForTracks();
+	
+	int getNumLoaded();
+	//blocks until more than numLoaded tracks are loaded, or all of them are, and returns the new count
+	int waitForProgress(int numLoaded);
+	int getNumTracks();
+	
+  protected:
+	class Worker : public ofThread {
+	  public:
+		ofxTLTrackLoader* loader;
+		void threadedFunction();
+	};
+	friend class Worker;
+	
+	//NULL once every track is taken
+	ofxTLTrack* takeNextTrack();
+	void trackLoaded();
+	
+	vector<ofxTLTrack*> tracks;
+	vector<Worker*> workers;
+	ofMutex queueLock;
+	Poco::Condition progress;
+	int nextTrack;
+	int numLoaded;
+};
@@ -0,0 +1,55 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "ofMain.h"
+
+//One edit to a track as the timeline keeps it on the undo stack.
+//Tracks that can describe their own changes hand these out from ofxTLTrack::endUndoDelta()
+//so undo stores the keys that changed instead of the whole track as xml before and after.
+//undo() and redo() are called alternately, starting with undo(), always with the track
+//in the state the edit left it in or the state before it.
+class ofxTLUndoDelta {
+  public:
+	virtual ~ofxTLUndoDelta(){}
+	
+	virtual void undo() = 0;
+	virtual void redo() = 0;
+	
+	//bytes held by this edit, counted against ofxTimeline::setUndoMemoryBudget()
+	virtual size_t getMemoryUsage() = 0;
+	
+	//folds the edit that came right after this one into it, so both are undone together
+	//returns false if they can't be combined, next is deleted by the caller either way
+	virtual bool coalesce(ofxTLUndoDelta* next){ return false; }
+};
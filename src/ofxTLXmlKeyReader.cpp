@@ -0,0 +1,328 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "ofxTLXmlKeyReader.h"
+
+//moves position just past the next occurrence of marker
+static bool skipPast(const char*& position, const char* end, const char* marker){
+	size_t markerLength = strlen(marker);
+	const char* found = search(position, end, marker, marker + markerLength);
+	if(found == end){
+		position = end;
+		return false;
+	}
+	position = found + markerLength;
+	return true;
+}
+
+static bool startsWith(const char* position, const char* end, const char* prefix){
+	size_t prefixLength = strlen(prefix);
+	return end - position >= prefixLength && memcmp(position, prefix, prefixLength) == 0;
+}
+
+static void appendUTF8(string& text, unsigned long codepoint){
+	if(codepoint < 0x80){
+		text += (char)codepoint;
+	}
+	else if(codepoint < 0x800){
+		text += (char)(0xC0 | (codepoint >> 6));
+		text += (char)(0x80 | (codepoint & 0x3F));
+	}
+	else if(codepoint < 0x10000){
+		text += (char)(0xE0 | (codepoint >> 12));
+		text += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+		text += (char)(0x80 | (codepoint & 0x3F));
+	}
+	else {
+		text += (char)(0xF0 | (codepoint >> 18));
+		text += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+		text += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+		text += (char)(0x80 | (codepoint & 0x3F));
+	}
+}
+
+//text with the entities tinyxml writes turned back into characters
+static void decodeEntities(const char* start, const char* end, string& text){
+	text.clear();
+	const char* c = start;
+	while(c < end){
+		if(*c != '&'){
+			text += *c++;
+			continue;
+		}
+		const char* entityEnd = find(c, MIN(c + 12, end), ';');
+		if(entityEnd == end || entityEnd == c + 12){
+			//not an entity, keep the ampersand
+			text += *c++;
+			continue;
+		}
+		string entity(c + 1, entityEnd);
+		if(entity == "amp") text += '&';
+		else if(entity == "lt") text += '<';
+		else if(entity == "gt") text += '>';
+		else if(entity == "quot") text += '"';
+		else if(entity == "apos") text += '\'';
+		else if(entity.size() > 2 && entity[0] == '#' && (entity[1] == 'x' || entity[1] == 'X')){
+			appendUTF8(text, strtoul(entity.c_str() + 2, NULL, 16));
+		}
+		else if(entity.size() > 1 && entity[0] == '#'){
+			appendUTF8(text, strtoul(entity.c_str() + 1, NULL, 10));
+		}
+		else {
+			text.append(c, entityEnd + 1);
+		}
+		c = entityEnd + 1;
+	}
+}
+
+ofxTLXmlKeyReader::ofxTLXmlKeyReader(const char* data, size_t length)
+:	position(data),
+	end(data + length),
+	failed(false),
+	numValues(0),
+	tagIsClosing(false),
+	tagIsEmpty(false)
+{
+	//
+}
+
+bool ofxTLXmlKeyReader::nextKey(){
+	numValues = 0;
+	while(!failed && readTag()){
+		if(tagIsClosing){
+			if(openTags.empty() || openTags.back() != tagName){
+				ofLogError("ofxTLXmlKeyReader::nextKey") << "unexpected closing tag </" << tagName << ">";
+				failed = true;
+				return false;
+			}
+			openTags.pop_back();
+		}
+		else if(tagName == "key" && openTags.size() == 1 && openTags[0] == "keyframes"){
+			return tagIsEmpty || readKeyValues();
+		}
+		else if(!tagIsEmpty){
+			openTags.push_back(tagName);
+		}
+	}
+	return false;
+}
+
+bool ofxTLXmlKeyReader::good(){
+	return !failed;
+}
+
+//reads the values of a key up to and including </key>
+bool ofxTLXmlKeyReader::readKeyValues(){
+	while(readTag()){
+		if(tagIsClosing){
+			if(tagName == "key"){
+				return true;
+			}
+			break;
+		}
+		
+		if(numValues == tagNames.size()){
+			tagNames.push_back("");
+			tagTexts.push_back("");
+		}
+		tagNames[numValues] = tagName;
+		string& text = tagTexts[numValues];
+		numValues++;
+		text.clear();
+		if(tagIsEmpty){
+			continue;
+		}
+		
+		readText(text);
+		if(!readTag()){
+			break;
+		}
+		//the timeline never nests elements inside a value, skip over them
+		if(!tagIsClosing){
+			text.clear();
+			if(!skipElement(tagIsEmpty ? 1 : 2)){
+				break;
+			}
+		}
+		else if(tagName != tagNames[numValues-1]){
+			break;
+		}
+	}
+	if(!failed){
+		ofLogError("ofxTLXmlKeyReader::readKeyValues") << "broken <key> element";
+	}
+	failed = true;
+	return false;
+}
+
+//reads tags until depth elements have closed
+bool ofxTLXmlKeyReader::skipElement(int depth){
+	while(readTag()){
+		if(tagIsClosing){
+			if(--depth == 0){
+				return true;
+			}
+		}
+		else if(!tagIsEmpty){
+			depth++;
+		}
+	}
+	failed = true;
+	return false;
+}
+
+//reads the next element tag, skipping text, comments and declarations
+bool ofxTLXmlKeyReader::readTag(){
+	while(true){
+		position = (const char*)memchr(position, '<', end - position);
+		if(position == NULL){
+			position = end;
+			return false;
+		}
+		bool skipped = true;
+		if(startsWith(position, end, "<?")){
+			skipped = skipPast(position, end, "?>");
+		}
+		else if(startsWith(position, end, "<!--")){
+			skipped = skipPast(position, end, "-->");
+		}
+		else if(startsWith(position, end, "<!")){
+			skipped = skipPast(position, end, ">");
+		}
+		else {
+			break;
+		}
+		if(!skipped){
+			failed = true;
+			return false;
+		}
+	}
+	
+	position++;
+	tagIsClosing = position < end && *position == '/';
+	if(tagIsClosing){
+		position++;
+	}
+	const char* nameStart = position;
+	while(position < end && !isspace(*position) && *position != '/' && *position != '>'){
+		position++;
+	}
+	tagName.assign(nameStart, position);
+	
+	//step over any attributes, minding quoted >
+	char quote = 0;
+	while(position < end && (quote != 0 || *position != '>')){
+		if(quote != 0){
+			if(*position == quote){
+				quote = 0;
+			}
+		}
+		else if(*position == '"' || *position == '\''){
+			quote = *position;
+		}
+		position++;
+	}
+	if(position == end || tagName.empty()){
+		ofLogError("ofxTLXmlKeyReader::readTag") << "unfinished tag";
+		failed = true;
+		return false;
+	}
+	tagIsEmpty = !tagIsClosing && position[-1] == '/';
+	position++;
+	return true;
+}
+
+//reads the text up to the next tag with surrounding whitespace trimmed
+void ofxTLXmlKeyReader::readText(string& text){
+	const char* textEnd = (const char*)memchr(position, '<', end - position);
+	if(textEnd == NULL){
+		textEnd = end;
+	}
+	const char* textStart = position;
+	position = textEnd;
+	while(textStart < textEnd && isspace(*textStart)){
+		textStart++;
+	}
+	while(textEnd > textStart && isspace(textEnd[-1])){
+		textEnd--;
+	}
+	if(memchr(textStart, '&', textEnd - textStart) == NULL){
+		text.assign(textStart, textEnd);
+	}
+	else{
+		decodeEntities(textStart, textEnd, text);
+	}
+}
+
+const string* ofxTLXmlKeyReader::findValue(const string& tag){
+	for(int i = 0; i < numValues; i++){
+		if(tagNames[i] == tag){
+			return &tagTexts[i];
+		}
+	}
+	return NULL;
+}
+
+int ofxTLXmlKeyReader::getValue(const string& tag, int defaultValue){
+	const string* text = findValue(tag);
+	return text != NULL ? atoi(text->c_str()) : defaultValue;
+}
+
+double ofxTLXmlKeyReader::getValue(const string& tag, double defaultValue){
+	const string* text = findValue(tag);
+	return text != NULL ? strtod(text->c_str(), NULL) : defaultValue;
+}
+
+string ofxTLXmlKeyReader::getValue(const string& tag, const string& defaultValue){
+	const string* text = findValue(tag);
+	return text != NULL ? *text : defaultValue;
+}
+
+string ofxTLXmlKeyReader::getValue(const string& tag, const char* defaultValue){
+	return getValue(tag, string(defaultValue));
+}
+
+bool ofxTLXmlKeyReader::tagExists(const string& tag){
+	return findValue(tag) != NULL;
+}
+
+int ofxTLXmlKeyReader::getNumValues(){
+	return numValues;
+}
+
+const string& ofxTLXmlKeyReader::getTagName(int index){
+	return tagNames[index];
+}
+
+const string& ofxTLXmlKeyReader::getTagText(int index){
+	return tagTexts[index];
+}
@@ -0,0 +1,87 @@
+/**
+ * ofxTimeline
+ * openFrameworks graphical timeline addon
+ *
+ * Copyright (c) 2011-2012 James George
+ * Development Supported by YCAM InterLab http://interlab.ycam.jp/en/
+ * http://jamesgeorge.org + http://flightphase.com
+ * http://github.com/obviousjim + http://github.com/flightphase
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "ofMain.h"
+
+//Reads the <key> elements of saved keyframe xml in one pass straight out of the text,
+//without building a document. Each call to nextKey() collects the key's child
+//values, which are looked up with the same getValue calls as ofxXmlSettings.
+//
+//Only the layout the timeline writes is understood: <key> elements directly inside
+//top level <keyframes> elements, each holding plain text values.
+class ofxTLXmlKeyReader {
+  public:
+	//data isn't copied and has to stay around while reading
+	ofxTLXmlKeyReader(const char* data, size_t length);
+	
+	//moves to the next key, false once there are none left or the xml is broken
+	bool nextKey();
+	//false if reading stopped at broken xml
+	bool good();
+	
+	//values of the current key
+	int getValue(const string& tag, int defaultValue);
+	double getValue(const string& tag, double defaultValue);
+	string getValue(const string& tag, const string& defaultValue);
+	string getValue(const string& tag, const char* defaultValue);
+	bool tagExists(const string& tag);
+	
+	int getNumValues();
+	const string& getTagName(int index);
+	const string& getTagText(int index);
+	
+  protected:
+	const char* position;
+	const char* end;
+	bool failed;
+	
+	//elements around the current position, so keys are only picked out of top level <keyframes>
+	vector<string> openTags;
+	
+	//storage is kept between keys so reading doesn't allocate once it's warmed up
+	vector<string> tagNames;
+	vector<string> tagTexts;
+	int numValues;
+	
+	//the tag under position, filled by readTag
+	string tagName;
+	bool tagIsClosing;
+	bool tagIsEmpty;
+	
+	bool readTag();
+	bool readKeyValues();
+	bool skipElement(int depth);
+	void readText(string& text);
+	const string* findValue(const string& tag);
+};
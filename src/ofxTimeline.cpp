@@ -32,6 +32,7 @@
 
 #include "ofxTimeline.h"
 #include "ofxHotKeys.h"
+#include "ofxTLTrackLoader.h"
 #ifdef TARGET_OSX
 #include "ofxRemoveCocoaMenu.h"
 #endif
@@ -60,6 +61,7 @@ ofxTimeline::ofxTimeline()
 	durationInSeconds(100.0f/30.0f),
 	isShowing(true),
 	isSetup(false),
+	isHeadless(false),
 	usingEvents(false),
 	isPlaying(false),
 	isEnabled(false),
@@ -80,9 +82,23 @@ ofxTimeline::ofxTimeline()
 	currentTime(0.0),
 	undoPointer(0),
 	undoEnabled(true),
+	curvesUseBinary(false),
+	preciseBangs(false),
+	bangLookaheadMillis(50),
+	queueEvents(false),
+	publishSnapshots(false),
 	isOnThread(false),
+	isOffline(false),
+	offlineWasOnThread(false),
+	offlineTime(0),
+	offlineFrame(0),
+	undoMemoryBudget(32*1024*1024),
+	undoMemoryUsage(0),
+	undoCoalesceMillis(500),
+	lastUndoPushMillis(0),
 	unsavedChanges(false),
-	curvesUseBinary(false),
+	loadTracksInParallel(false),
+	numLoadThreads(4),
 	headersAreEditable(false),
 	minimalHeaders(false),
    	//copy from ofxTimeline/assets into bin/data/
@@ -119,7 +135,14 @@ void ofxTimeline::setup(){
     
 	isSetup = true;
 	
-	width = ofGetWidth();
+	if(isHeadless){
+		//there's no window to follow, any width will do since nothing is drawn
+		lockWidthToWindow = false;
+		width = 1024;
+	}
+	else{
+		width = ofGetWidth();
+	}
     if(tabs != NULL){
         delete tabs;
     }
@@ -163,6 +186,18 @@ void ofxTimeline::setup(){
 
 }
 
+void ofxTimeline::setHeadless(bool headless){
+	if(isSetup){
+		ofLogError("ofxTimeline::setHeadless -- Call before setup()");
+		return;
+	}
+	isHeadless = headless;
+}
+
+bool ofxTimeline::getIsHeadless(){
+	return isHeadless;
+}
+
 void ofxTimeline::moveToThread(){
 	if(!isOnThread){
 		stop();
@@ -183,6 +218,165 @@ void ofxTimeline::removeFromThread(){
 	}
 }
 
+void ofxTimeline::setThreadTickRate(double ticksPerSecond){
+	threadClock.setTickRate(ticksPerSecond);
+}
+
+double ofxTimeline::getThreadTickRate(){
+	return threadClock.getTickRate();
+}
+
+ofxTLClockStats ofxTimeline::getThreadClockStats(){
+	return threadClock.getStats();
+}
+
+void ofxTimeline::resetThreadClockStats(){
+	threadClock.resetStats();
+}
+
+void ofxTimeline::setPreciseBangs(bool usePreciseBangs, float lookaheadMillis){
+	preciseBangs = usePreciseBangs;
+	bangLookaheadMillis = MAX(lookaheadMillis, 0);
+	if(preciseBangs){
+		bangScheduler.start(this);
+	}
+	else{
+		bangScheduler.stop();
+	}
+}
+
+bool ofxTimeline::getPreciseBangs(){
+	return preciseBangs;
+}
+
+float ofxTimeline::getBangLookaheadMillis(){
+	return bangLookaheadMillis;
+}
+
+ofxTLLatencyHistogram ofxTimeline::getBangLatency(){
+	bangLatencyLock.lock();
+	ofxTLLatencyHistogram latency = bangLatency;
+	bangLatencyLock.unlock();
+	return latency;
+}
+
+void ofxTimeline::resetBangLatency(){
+	bangLatencyLock.lock();
+	bangLatency.reset();
+	bangLatencyLock.unlock();
+}
+
+void ofxTimeline::sendBangEvent(ofxTLBangEventArgs& args){
+	if(isOffline){
+		ofxTLQueuedEvent event;
+		event.type = ofxTLQueuedEvent::BANG;
+		event.timestampNanos = ofxTLClock::getNanos();
+		event.bang = args;
+		offlineEvents.push_back(event);
+		return;
+	}
+	bangLatencyLock.lock();
+	bangLatency.add(args.latenessMillis*1000.0);
+	bangLatencyLock.unlock();
+	if(queueEvents){
+		ofxTLQueuedEvent event;
+		event.type = ofxTLQueuedEvent::BANG;
+		event.timestampNanos = ofxTLClock::getNanos();
+		event.bang = args;
+		eventQueueLock.lock();
+		eventQueue.push(event);
+		eventQueueLock.unlock();
+	}
+	else{
+		ofNotifyEvent(timelineEvents.bangFired, args);
+	}
+}
+
+void ofxTimeline::sendSwitchEvent(ofxTLSwitchEventArgs& args){
+	if(isOffline){
+		ofxTLQueuedEvent event;
+		event.type = ofxTLQueuedEvent::SWITCH;
+		event.timestampNanos = ofxTLClock::getNanos();
+		event.switched = args;
+		offlineEvents.push_back(event);
+		return;
+	}
+	if(queueEvents){
+		ofxTLQueuedEvent event;
+		event.type = ofxTLQueuedEvent::SWITCH;
+		event.timestampNanos = ofxTLClock::getNanos();
+		event.switched = args;
+		eventQueueLock.lock();
+		eventQueue.push(event);
+		eventQueueLock.unlock();
+	}
+	else{
+		ofNotifyEvent(timelineEvents.switched, args);
+	}
+}
+
+void ofxTimeline::setQueueEvents(bool shouldQueueEvents, int queueSize){
+	if(shouldQueueEvents && eventQueue.getCapacity() < queueSize){
+		//the threads sending events wait while the slots are replaced
+		eventQueueLock.lock();
+		eventQueue.allocate(queueSize);
+		eventQueueLock.unlock();
+	}
+	queueEvents = shouldQueueEvents;
+	if(!queueEvents){
+		//let whatever was waiting through so nothing is lost
+		dispatchQueuedEvents();
+	}
+}
+
+bool ofxTimeline::getQueueEvents(){
+	return queueEvents;
+}
+
+int ofxTimeline::dispatchQueuedEvents(){
+	int numSent = 0;
+	ofxTLQueuedEvent event;
+	while(eventQueue.pop(event)){
+		if(event.type == ofxTLQueuedEvent::BANG){
+			ofNotifyEvent(timelineEvents.bangFired, event.bang);
+		}
+		else{
+			ofNotifyEvent(timelineEvents.switched, event.switched);
+		}
+		numSent++;
+	}
+	return numSent;
+}
+
+ofxTLEventQueue& ofxTimeline::getEventQueue(){
+	return eventQueue;
+}
+
+void ofxTimeline::setPublishSnapshots(bool shouldPublishSnapshots){
+	publishSnapshots = shouldPublishSnapshots;
+}
+
+bool ofxTimeline::getPublishSnapshots(){
+	return publishSnapshots;
+}
+
+bool ofxTimeline::getSnapshot(ofxTLSnapshot& snapshot){
+	return snapshots.read(snapshot);
+}
+
+void ofxTimeline::publishSnapshot(){
+	snapshotTracks.clear();
+	for(int i = 0; i < pages.size(); i++){
+		vector<ofxTLTrack*>& tracks = pages[i]->getTracks();
+		snapshotTracks.insert(snapshotTracks.end(), tracks.begin(), tracks.end());
+	}
+	snapshots.publish(snapshotTracks, getCurrentTimeMillis(), getIsPlaying());
+}
+
+ofxTLBangScheduler& ofxTimeline::getBangScheduler(){
+	return bangScheduler;
+}
+
 void ofxTimeline::setName(string newName){
     if(newName != name){
         string oldName = name;
@@ -226,10 +420,43 @@ string ofxTimeline::getWorkingFolder(){
 }
 
 void ofxTimeline::loadTracksFromFolder(string folderPath){
+	vector<ofxTLTrack*> mainThreadTracks;
+	vector<ofxTLTrack*> threadedTracks;
     for(int i = 0; i < pages.size(); i++){
-        pages[i]->loadTracksFromFolder(folderPath);
+        pages[i]->setTracksFolder(folderPath);
+		vector<ofxTLTrack*>& pageTracks = pages[i]->getTracks();
+		for(int t = 0; t < pageTracks.size(); t++){
+			if(loadTracksInParallel && pageTracks[t]->canLoadOnThread()){
+				threadedTracks.push_back(pageTracks[t]);
+			}
+			else{
+				mainThreadTracks.push_back(pageTracks[t]);
+			}
+		}
     }
 	
+	ofxTLLoadEventArgs args;
+	args.sender = this;
+	args.tracksLoaded = 0;
+	args.totalTracks = mainThreadTracks.size() + threadedTracks.size();
+	
+	ofxTLTrackLoader loader;
+	loader.start(threadedTracks, numLoadThreads);
+	for(int i = 0; i < mainThreadTracks.size(); i++){
+		mainThreadTracks[i]->load();
+		args.tracksLoaded = i + 1 + loader.getNumLoaded();
+		ofNotifyEvent(events().loadProgress, args);
+	}
+	//report the workers' progress from here so listeners are only ever called on the main thread
+	while(args.tracksLoaded < args.totalTracks){
+		args.tracksLoaded = mainThreadTracks.size() + loader.waitForProgress(args.tracksLoaded - mainThreadTracks.size());
+		ofNotifyEvent(events().loadProgress, args);
+	}
+	loader.waitForTracks();
+	for(int i = 0; i < threadedTracks.size(); i++){
+		threadedTracks[i]->finishLoad();
+	}
+	
 //	cout << "*****TL " << name << " Loading tracks from " << folderPath << endl;
 	
 	setWorkingFolder(folderPath);
@@ -313,7 +540,8 @@ void ofxTimeline::setupFont(string newFontPath, int newFontSize){
 }
 
 OFX_TIMELINE_FONT_RENDERER & ofxTimeline::getFont(){
-	if(!font.isLoaded()){
+	//loading makes textures, so headless timelines hand out the empty font
+	if(!font.isLoaded() && !isHeadless){
 		setupFont();
 	}
 	return font;
@@ -338,29 +566,77 @@ vector<string>& ofxTimeline::getPasteboard(){
 //turn on undo
 void ofxTimeline::enableUndo(bool enabled){
 	undoEnabled = enabled;    
+	if(!undoEnabled){
+		clearUndoStack();
+	}
 }
 
 void ofxTimeline::undo(){
+	//an edit still being recorded wouldn't match the tracks afterwards
+	discardStateBuffers();
     if(undoPointer > 0){
     	undoPointer--;
-        restoreToState(undoStack[undoPointer]);
+        restoreToState(undoStack[undoPointer], true);
 		unsavedChanges = true;		
     }
 }
 
 void ofxTimeline::redo(){
-    if(undoPointer < undoStack.size()-1){
+	discardStateBuffers();
+    if(undoPointer < undoStack.size()){
+		restoreToState(undoStack[undoPointer], false);
         undoPointer++;
-		restoreToState(undoStack[undoPointer]);
 		unsavedChanges = true;
     }
 }
 
-void ofxTimeline::restoreToState(vector<UndoItem>& state){
-    for(int i = 0; i < state.size(); i++){
+void ofxTimeline::setUndoMemoryBudget(size_t bytes){
+	undoMemoryBudget = bytes;
+	//forget the oldest edits but always keep the latest one
+	while(undoMemoryUsage > undoMemoryBudget && undoStack.size() > 1 && undoPointer > 0){
+		deleteUndoState(undoStack.front());
+		undoStack.pop_front();
+		undoPointer--;
+	}
+}
+
+size_t ofxTimeline::getUndoMemoryBudget(){
+	return undoMemoryBudget;
+}
+
+size_t ofxTimeline::getUndoMemoryUsage(){
+	return undoMemoryUsage;
+}
+
+void ofxTimeline::setUndoCoalesceMillis(unsigned long long millis){
+	undoCoalesceMillis = millis;
+}
+
+unsigned long long ofxTimeline::getUndoCoalesceMillis(){
+	return undoCoalesceMillis;
+}
+
+//each step holds one edit, undo runs it backwards and redo forwards
+//xml items hold the state on the other side of the edit, so swap it for the current one
+void ofxTimeline::restoreToState(vector<UndoItem>& state, bool undoing){
+    for(int n = 0; n < state.size(); n++){
+		int i = undoing ? state.size()-1-n : n;
 //		cout << "restoring state for track " << state[i].track->getDisplayName() << endl;
-//		cout << state[i].stateBuffer << endl;
-        state[i].track->loadFromXMLRepresentation(state[i].stateBuffer);
+		if(state[i].delta != NULL){
+			if(undoing){
+				state[i].delta->undo();
+			}
+			else{
+				state[i].delta->redo();
+			}
+		}
+		else{
+			string currentState = state[i].track->getXMLRepresentation();
+			state[i].track->loadFromXMLRepresentation(state[i].stateBuffer);
+			undoMemoryUsage += currentState.size();
+			undoMemoryUsage -= state[i].stateBuffer.size();
+			state[i].stateBuffer.swap(currentState);
+		}
     }
 }
 
@@ -368,12 +644,13 @@ void ofxTimeline::restoreToState(vector<UndoItem>& state){
 //stores the state of all tracks that could potentially be modified
 //by this action so that we can push ones that actually were changed
 //onto the undo stack
+//tracks that support deltas start recording their edit instead
 void ofxTimeline::collectStateBuffers(){
     
     if(!undoEnabled) return;
     
     vector<ofxTLTrack*> tracks = currentPage->getTracks();
-    stateBuffers.clear();
+	discardStateBuffers();
     modifiedTracks.clear();
     for(int i = 0; i < tracks.size(); i++){
         ofxTLTrack* track = tracks[i];
@@ -381,15 +658,29 @@ void ofxTimeline::collectStateBuffers(){
 			
             UndoItem ui;
             ui.track = track;
-            ui.stateBuffer = track->getXMLRepresentation();
+			ui.delta = NULL;
+			if(track->supportsUndoDeltas()){
+				track->beginUndoDelta();
+			}
+			else{
+				ui.stateBuffer = track->getXMLRepresentation();
+			}
             stateBuffers.push_back(ui);
 //			cout << "collecting state for " << track->getDisplayName() << endl;
-//			cout << ui.stateBuffer << endl;
 	
         }
     }
 }
 
+void ofxTimeline::discardStateBuffers(){
+	for(int i = 0; i < stateBuffers.size(); i++){
+		if(stateBuffers[i].track->supportsUndoDeltas()){
+			delete stateBuffers[i].track->endUndoDelta();
+		}
+	}
+	stateBuffers.clear();
+}
+
 //go through the state buffers and see which tracks were actually modified
 //push the collection of them onto the stack if there were any
 void ofxTimeline::pushUndoStack(){
@@ -398,39 +689,88 @@ void ofxTimeline::pushUndoStack(){
     if(!undoEnabled) return;
     
     vector<UndoItem> undoCollection;
-	set<ofxTLTrack*>::iterator trackit;
-//    for(int i = 0; i < modifiedTracks.size(); i++){
-	for(trackit = modifiedTracks.begin(); trackit != modifiedTracks.end(); trackit++){
-        for(int buf = 0; buf < stateBuffers.size(); buf++){
-            //this m
-            if(*trackit == stateBuffers[buf].track){
-//				cout << "modified state buffer for " << modifiedTracks[i]->getDisplayName() << endl;
-                undoCollection.push_back(stateBuffers[buf]);
-            }
-        }
-    }
+	for(int buf = 0; buf < stateBuffers.size(); buf++){
+		UndoItem& ui = stateBuffers[buf];
+		bool modified = modifiedTracks.find(ui.track) != modifiedTracks.end();
+		if(ui.track->supportsUndoDeltas()){
+			ui.delta = ui.track->endUndoDelta();
+			if(ui.delta != NULL && !modified){
+				delete ui.delta;
+				ui.delta = NULL;
+			}
+			if(ui.delta != NULL){
+				undoCollection.push_back(ui);
+			}
+		}
+		else if(modified){
+//			cout << "modified state buffer for " << ui.track->getDisplayName() << endl;
+			undoCollection.push_back(ui);
+		}
+	}
+	stateBuffers.clear();
+	modifiedTracks.clear();
 	
     if(undoCollection.size() > 0){
         //remove any history that we've undone
         while(undoPointer < undoStack.size()){
+			deleteUndoState(undoStack.back());
             undoStack.pop_back();
         }
+		
+		//fold a quick run of edits to the same keys into the last step
+		unsigned long long now = ofGetElapsedTimeMillis();
+		if(undoCoalesceMillis > 0 && now - lastUndoPushMillis <= undoCoalesceMillis &&
+		   undoStack.size() > 0 && undoStack.back().size() == 1 && undoCollection.size() == 1 &&
+		   undoStack.back()[0].track == undoCollection[0].track &&
+		   undoStack.back()[0].delta != NULL && undoCollection[0].delta != NULL)
+		{
+			UndoItem& last = undoStack.back()[0];
+			size_t lastMemory = last.delta->getMemoryUsage();
+			if(last.delta->coalesce(undoCollection[0].delta)){
+				undoMemoryUsage += last.delta->getMemoryUsage();
+				undoMemoryUsage -= lastMemory;
+				delete undoCollection[0].delta;
+				lastUndoPushMillis = now;
+				return;
+			}
+		}
+		
         undoStack.push_back(undoCollection);
         undoPointer = undoStack.size();
-        
-        //store the most recent state at the top of the queue
-        vector<UndoItem> currentState;
-		for(trackit = modifiedTracks.begin(); trackit != modifiedTracks.end(); trackit++){
-            UndoItem ui;
-            ui.track = *trackit;//modifiedTracks[i];
-            ui.stateBuffer = (*trackit)->getXMLRepresentation();
-            currentState.push_back(ui);
-        }
-        undoStack.push_back(currentState);
+		undoMemoryUsage += getUndoStateMemory(undoCollection);
+		lastUndoPushMillis = now;
+		setUndoMemoryBudget(undoMemoryBudget);
     }
 	
 }
 
+size_t ofxTimeline::getUndoStateMemory(vector<UndoItem>& state){
+	size_t bytes = 0;
+	for(int i = 0; i < state.size(); i++){
+		bytes += state[i].delta != NULL ? state[i].delta->getMemoryUsage() : state[i].stateBuffer.size();
+	}
+	return bytes;
+}
+
+void ofxTimeline::deleteUndoState(vector<UndoItem>& state){
+	undoMemoryUsage -= MIN(undoMemoryUsage, getUndoStateMemory(state));
+	for(int i = 0; i < state.size(); i++){
+		delete state[i].delta;
+		state[i].delta = NULL;
+	}
+	state.clear();
+}
+
+void ofxTimeline::clearUndoStack(){
+	discardStateBuffers();
+	for(int i = 0; i < undoStack.size(); i++){
+		deleteUndoState(undoStack[i]);
+	}
+	undoStack.clear();
+	undoPointer = 0;
+	undoMemoryUsage = 0;
+}
+
 void ofxTimeline::setMovePlayheadOnDrag(bool movePlayhead){
 	movePlayheadOnDrag = movePlayhead;
 }
@@ -513,7 +853,7 @@ void ofxTimeline::play(){
 		
 		isPlaying = true;
         currentTime = ofClamp(currentTime, getInTimeInSeconds(), getOutTimeInSeconds());
-        playbackStartTime = timer.getAppTimeSeconds() - currentTime;
+        playbackStartTime = ofxTLClock::getSeconds() - currentTime;
         playbackStartFrame = ofGetFrameNum() - timecode.frameForSeconds(currentTime);        
 		ofxTLPlaybackEventArgs args = createPlaybackEvent();
 		ofNotifyEvent(timelineEvents.playbackStarted, args);
@@ -623,6 +963,114 @@ void ofxTimeline::setCurrentTimeMillis(unsigned long long millis){
 	setCurrentTimeSeconds(millis/1000.);
 }
 
+static unsigned long long offlineEventMillis(const ofxTLQueuedEvent& event){
+	return event.type == ofxTLQueuedEvent::BANG ? event.bang.scheduledMillis : event.switched.switchMillis;
+}
+
+static bool offlineEventIsEarlier(const ofxTLQueuedEvent& a, const ofxTLQueuedEvent& b){
+	return offlineEventMillis(a) < offlineEventMillis(b);
+}
+
+void ofxTimeline::beginOffline(){
+	beginOffline(getInTimeInMillis());
+}
+
+void ofxTimeline::beginOffline(unsigned long long startMillis){
+	if(isOffline){
+		ofLogError("ofxTimeline::beginOffline -- Already offline");
+		return;
+	}
+	stop();
+	offlineWasOnThread = isOnThread;
+	removeFromThread();
+	isOffline = true;
+	offlineTime = startMillis/1000.0;
+	offlineFrame = timecode.frameForSeconds(offlineTime);
+	currentTime = offlineTime;
+	//a key right on the start is sent by the first step
+	jumpPlayhead();
+	if(publishSnapshots){
+		publishSnapshot();
+	}
+}
+
+void ofxTimeline::endOffline(){
+	if(!isOffline){
+		return;
+	}
+	isOffline = false;
+	offlineEvents.clear();
+	if(offlineWasOnThread){
+		moveToThread();
+	}
+}
+
+bool ofxTimeline::getIsOffline(){
+	return isOffline;
+}
+
+void ofxTimeline::stepToMillis(unsigned long long millis){
+	stepOfflineTo(millis/1000.0);
+	offlineFrame = timecode.frameForSeconds(offlineTime);
+}
+
+void ofxTimeline::stepToFrame(int frame){
+	stepOfflineTo(timecode.secondsForFrame(frame));
+	offlineFrame = frame;
+}
+
+void ofxTimeline::stepFrame(){
+	stepToFrame(offlineFrame+1);
+}
+
+void ofxTimeline::stepSeconds(double seconds){
+	stepOfflineTo(offlineTime + seconds);
+	offlineFrame = timecode.frameForSeconds(offlineTime);
+}
+
+void ofxTimeline::stepOfflineTo(double seconds){
+	if(!isOffline){
+		ofLogError("ofxTimeline::step -- Call beginOffline() before stepping");
+		return;
+	}
+	bool backwards = seconds < offlineTime;
+	offlineTime = ofClamp(seconds, 0, durationInSeconds);
+	currentTime = offlineTime;
+	if(backwards){
+		jumpPlayhead();
+	}
+	else{
+		checkEvents();
+		sendOfflineEvents();
+	}
+	if(publishSnapshots){
+		publishSnapshot();
+	}
+}
+
+void ofxTimeline::sendOfflineEvents(){
+	//tracks send theirs one track after another, so put the step back in time order
+	stable_sort(offlineEvents.begin(), offlineEvents.end(), offlineEventIsEarlier);
+	for(int i = 0; i < offlineEvents.size(); i++){
+		if(offlineEvents[i].type == ofxTLQueuedEvent::BANG){
+			ofNotifyEvent(timelineEvents.bangFired, offlineEvents[i].bang);
+		}
+		else{
+			ofNotifyEvent(timelineEvents.switched, offlineEvents[i].switched);
+		}
+	}
+	offlineEvents.clear();
+}
+
+void ofxTimeline::jumpPlayhead(){
+	for(int i = 0; i < pages.size(); i++){
+		vector<ofxTLTrack*>& tracks = pages[i]->getTracks();
+		for(int t = 0; t < tracks.size(); t++){
+			tracks[t]->playheadJumped();
+		}
+	}
+}
+
 void ofxTimeline::setFrameRate(float fps){
 	timecode.setFPS(fps);    
 }
@@ -647,6 +1095,13 @@ float ofxTimeline::getCurrentTime(){
 	return currentTime;
 }
 
+double ofxTimeline::getPreciseTimeMillis(){
+	if(getIsPlaying() && timeControl == NULL && !isFrameBased){
+		return (ofxTLClock::getSeconds() - playbackStartTime)*1000.0;
+	}
+	return currentTime*1000.0;
+}
+
 float ofxTimeline::getPercentComplete(){
     return currentTime / durationInSeconds;
 }
@@ -772,7 +1227,9 @@ bool ofxTimeline::toggleEnabled(){
 void ofxTimeline::enable(){
     if(!isEnabled){
 		isEnabled = true;
-		enableEvents();
+		if(!isHeadless){
+			enableEvents();
+		}
     }
 }
 
@@ -803,9 +1260,15 @@ void ofxTimeline::reset(){ //gets rid of everything
 	if(isOnThread){
 		waitForThread(true);
 	}
+	//queued bangs point at the tracks
+	bangScheduler.stop();
+	preciseBangs = false;
+	eventQueue.clear();
+	offlineEvents.clear();
     
     disable();
-    undoStack.clear();
+    //deltas hold keys that belong to the tracks, so let them go before the pages
+    clearUndoStack();
     for(int i = 0; i < pages.size(); i++){ 
         delete pages[i];
     }
@@ -816,6 +1279,11 @@ void ofxTimeline::reset(){ //gets rid of everything
     setInOutRange(ofRange(0,1.0));
     pages.clear();
     trackNameToPage.clear();
+    trackNameToTrack.clear();
+	//so the published layout stops pointing at the deleted tracks
+	if(publishSnapshots){
+		publishSnapshot();
+	}
     currentPage = NULL;
     modalTrack = NULL;
     timeControl = NULL;
@@ -880,6 +1348,15 @@ void ofxTimeline::setAutosave(bool doAutosave){
 	autosave = doAutosave;
 }
 
+void ofxTimeline::setLoadTracksInParallel(bool loadInParallel, int numThreads){
+	loadTracksInParallel = loadInParallel;
+	numLoadThreads = MAX(numThreads, 1);
+}
+
+bool ofxTimeline::getLoadTracksInParallel(){
+	return loadTracksInParallel;
+}
+
 void ofxTimeline::setOffset(ofVec2f newOffset){
     if(offset != newOffset){
         offset = newOffset;
@@ -890,8 +1367,8 @@ void ofxTimeline::setOffset(ofVec2f newOffset){
 }
 
 void ofxTimeline::setLockWidthToWindow(bool lockWidth){
-    lockWidthToWindow = lockWidth;
-    if(width != ofGetWidth()){
+    lockWidthToWindow = lockWidth && !isHeadless;
+    if(!isHeadless && width != ofGetWidth()){
         recalculateBoundingRects();
     }
 }
@@ -941,7 +1418,7 @@ bool ofxTimeline::getLockWidthToWindow(){
 
 void ofxTimeline::setWidth(float newWidth){
     if(width != newWidth){
-		if(newWidth != ofGetWidth()){
+		if(isHeadless || newWidth != ofGetWidth()){
 			lockWidthToWindow = false;
 		}
         width = newWidth;
@@ -1409,15 +1886,18 @@ bool ofxTimeline::isDone(){
 }
 
 void ofxTimeline::update(ofEventArgs& updateArgs){
-	if(!isOnThread){
+	//offline the playhead only moves when stepped
+	if(!isOnThread && !isOffline){
 		updateTime();
 	}
 }
 
 void ofxTimeline::threadedFunction(){
+	threadClock.resetStats();
+	threadClock.start();
 	while(isThreadRunning()){
 		updateTime();
-		ofSleepMillis(1);
+		threadClock.waitForNextTick();
 	}
 }
 
@@ -1425,17 +1905,25 @@ void ofxTimeline::updateTime(){
 	
 	if(getIsPlaying()){
 		if(timeControl == NULL){
-			if(isFrameBased){
+			if(isFrameBased && isOnThread){
+				//step through whole frames of clock time
+				currentTime = timecode.secondsForFrame(timecode.frameForSeconds(ofxTLClock::getSeconds() - playbackStartTime));
+			}
+			else if(isFrameBased){
 				currentTime = timecode.secondsForFrame(ofGetFrameNum() - playbackStartFrame);
 			}
 			else {
-				currentTime = timer.getAppTimeSeconds() - playbackStartTime;
+				currentTime = ofxTLClock::getSeconds() - playbackStartTime;
 			}
 			checkLoop();
 		}
 	}
 	
 	checkEvents();
+	
+	if(publishSnapshots){
+		publishSnapshot();
+	}
 }
 
 void ofxTimeline::checkEvents(){
@@ -1447,7 +1935,7 @@ void ofxTimeline::checkEvents(){
 void ofxTimeline::checkLoop(){
 	if(currentTime < durationInSeconds*inoutRange.min){
         currentTime = durationInSeconds*inoutRange.min;
-        playbackStartTime = timer.getAppTimeSeconds() - currentTime;
+        playbackStartTime = ofxTLClock::getSeconds() - currentTime;
         playbackStartFrame = ofGetFrameNum() - timecode.frameForSeconds(currentTime);
     }
     
@@ -1468,7 +1956,7 @@ void ofxTimeline::checkLoop(){
 
 void ofxTimeline::draw(){
 
-	if(isSetup && isShowing){
+	if(isSetup && isShowing && !isHeadless){
 		ofPushStyle();
 
 		glPushAttrib(GL_ENABLE_BIT);
@@ -1642,8 +2130,14 @@ void ofxTimeline::addTrack(string trackName, ofxTLTrack* track){
     }
 	track->setTimeline( this );
 	track->setName( trackName );
+	//set before the page adds the track, since that loads it
+	ofxTLKeyframes* keyframes = dynamic_cast<ofxTLKeyframes*>(track);
+	if(keyframes != NULL && curvesUseBinary){
+		keyframes->useBinarySave = true;
+	}
 	currentPage->addTrack(trackName, track);	
 	trackNameToPage[trackName] = currentPage;
+	trackNameToTrack[trackName] = track;
 	ofEventArgs args;
 	ofNotifyEvent(events().viewWasResized, args);
 }
@@ -1670,7 +2164,6 @@ ofxTLCurves* ofxTimeline::addCurves(string trackName, ofRange valueRange, float
 
 ofxTLCurves* ofxTimeline::addCurves(string trackName, string xmlFileName, ofRange valueRange, float defaultValue){
 	ofxTLCurves* newCurves = new ofxTLCurves();
-	newCurves->useBinarySave = curvesUseBinary;
 	newCurves->setCreatedByTimeline(true);
 	newCurves->setValueRange(valueRange, defaultValue);
 	newCurves->setXMLFileName(xmlFileName);
@@ -1679,29 +2172,29 @@ ofxTLCurves* ofxTimeline::addCurves(string trackName, string xmlFileName, ofRang
 }
 
 float ofxTimeline::getValueAtPercent(string trackName, float atPercent){
-	if(!hasTrack(trackName)){
+	ofxTLKeyframes* curves = findTrackAs<ofxTLKeyframes>(trackName);
+	if(curves == NULL){
 		ofLogError("ofxTimeline -- Couldn't find track " + trackName);
 		return 0.0;
 	}
-	ofxTLCurves* curves = (ofxTLCurves*)trackNameToPage[trackName]->getTrack(trackName);
 	return curves->getValueAtTimeInMillis(atPercent*durationInSeconds*1000);
 }
 
 float ofxTimeline::getValue(string trackName, float atTime){
-	if(!hasTrack(trackName)){
+	ofxTLKeyframes* curves = findTrackAs<ofxTLKeyframes>(trackName);
+	if(curves == NULL){
 		ofLogError("ofxTimeline -- Couldn't find track " + trackName);
 		return 0.0;
 	}
-	ofxTLCurves* curves = (ofxTLCurves*)trackNameToPage[trackName]->getTrack(trackName);
 	return curves->getValueAtTimeInMillis(atTime*1000);
 }
 
 float ofxTimeline::getValue(string trackName){
-	if(!hasTrack(trackName)){
+	ofxTLKeyframes* curves = findTrackAs<ofxTLKeyframes>(trackName);
+	if(curves == NULL){
 		ofLogError("ofxTimeline -- Couldn't find track " + trackName);
 		return 0.0;
 	}
-	ofxTLCurves* curves = (ofxTLCurves*)trackNameToPage[trackName]->getTrack(trackName);
 	return curves->getValue();
 }
 
@@ -1723,11 +2216,16 @@ bool ofxTimeline::hasPage(string pageName){
 }
 
 ofxTLTrack* ofxTimeline::getTrack(string trackName){
-	if(!hasTrack(trackName)){
+	ofxTLTrack* track = findTrack(trackName);
+	if(track == NULL){
 		ofLogError("ofxTimeline -- Couldn't find track " + trackName);
-		return NULL;
 	}
-	return trackNameToPage[trackName]->getTrack(trackName);
+	return track;
+}
+
+ofxTLTrack* ofxTimeline::findTrack(const string& trackName){
+	map<string, ofxTLTrack*>::iterator it = trackNameToTrack.find(trackName);
+	return it != trackNameToTrack.end() ? it->second : NULL;
 }
 
 ofxTLPage* ofxTimeline::getPage(string pageName){
@@ -1757,22 +2255,22 @@ ofxTLSwitches* ofxTimeline::addSwitches(string trackName, string xmlFileName){
 }
 
 bool ofxTimeline::isSwitchOn(string trackName, float atTime){
-	if(!hasTrack(trackName)){
+	ofxTLSwitches* switches = findTrackAs<ofxTLSwitches>(trackName);
+	if(switches == NULL){
 		ofLogError("ofxTimeline -- Couldn't find switcher track " + trackName);
 		return false;
 	}
 	
-	ofxTLSwitches* switches = (ofxTLSwitches*)trackNameToPage[trackName]->getTrack(trackName);
     return switches->isOnAtPercent(atTime/durationInSeconds);
 }
 
 bool ofxTimeline::isSwitchOn(string trackName){
-	if(!hasTrack(trackName)){
+	ofxTLSwitches* switches = findTrackAs<ofxTLSwitches>(trackName);
+	if(switches == NULL){
 		ofLogError("ofxTimeline -- Couldn't find switcher track " + trackName);
 		return false;
 	}
 	
-	ofxTLSwitches* switches = (ofxTLSwitches*)trackNameToPage[trackName]->getTrack(trackName);
 	return switches->isOn();
 //    return isSwitchOn(trackName, currentTime);
 }
@@ -1845,11 +2343,11 @@ ofxTLColorTrack* ofxTimeline::addColorsWithPalette(string trackName, string xmlF
 }
 
 ofColor ofxTimeline::getColor(string trackName){
-	if(!hasTrack(trackName)){
+	ofxTLColorTrack* colors = findTrackAs<ofxTLColorTrack>(trackName);
+	if(colors == NULL){
 		ofLogError("ofxTimeline -- Couldn't find color track " + trackName);
 		return ofColor(0,0,0);
 	}
-	ofxTLColorTrack* colors = (ofxTLColorTrack*)trackNameToPage[trackName]->getTrack(trackName);
 	return colors->getColor();
 }
 
@@ -1862,12 +2360,12 @@ ofColor ofxTimeline::getColorAtSecond(string trackName, float second){
 }
 
 ofColor ofxTimeline::getColorAtMillis(string trackName, unsigned long long millis){
-	if(!hasTrack(trackName)){
+	ofxTLColorTrack* colors = findTrackAs<ofxTLColorTrack>(trackName);
+	if(colors == NULL){
 	   ofLogError("ofxTimeline -- Couldn't find color track " + trackName);
 		return ofColor(0,0,0);
 	}
 	
-	ofxTLColorTrack* colors = (ofxTLColorTrack*)trackNameToPage[trackName]->getTrack(trackName);
 	return colors->getColorAtMillis(millis);
 }
 
@@ -2015,9 +2513,19 @@ void ofxTimeline::removeTrack(string name){
 	}
     //quick fix for now -- we need to have Undo and Delete track work together
     //but to prevent crashes, let's just go through the undo queue and remove any items that have to do with this track
+    for(int i = stateBuffers.size()-1; i >= 0; i--){
+		if(stateBuffers[i].track == track){
+			if(track->supportsUndoDeltas()){
+				delete track->endUndoDelta();
+			}
+			stateBuffers.erase(stateBuffers.begin() + i);
+		}
+	}
     for(int i = 0; i < undoStack.size(); i++){
         for(int q = undoStack[i].size()-1; q >= 0; q--){
 			if(undoStack[i][q].track == track){
+				vector<UndoItem> removedItem(1, undoStack[i][q]);
+				deleteUndoState(removedItem);
                 undoStack[i].erase(undoStack[i].begin() + q);
                 cout << "temporary fix -- deleting undo queue element for track " << track->getName() << endl;
             }
@@ -2026,6 +2534,18 @@ void ofxTimeline::removeTrack(string name){
 
     trackNameToPage[name]->removeTrack(track);
     trackNameToPage.erase(name);
+    trackNameToTrack.erase(name);
+	//the track is gone, so its queued bangs and switches must not reach the listeners
+	//deleting it stopped it sending, only the address is compared
+	eventQueueLock.lock();
+	eventQueue.discardTrack(track);
+	eventQueueLock.unlock();
+	for(int i = offlineEvents.size()-1; i >= 0; i--){
+		ofxTLTrack* sender = offlineEvents[i].type == ofxTLQueuedEvent::BANG ? offlineEvents[i].bang.track : offlineEvents[i].switched.track;
+		if(sender == track){
+			offlineEvents.erase(offlineEvents.begin() + i);
+		}
+	}
 	ofEventArgs args;
 	ofNotifyEvent(events().viewWasResized, args);
 }
@@ -51,6 +51,11 @@
 //external addons
 #include "ofRange.h"
 #include "ofxMSATimer.h"
+#include "ofxTLClock.h"
+#include "ofxTLBangScheduler.h"
+#include "ofxTLLatencyHistogram.h"
+#include "ofxTLEventQueue.h"
+#include "ofxTLSnapshot.h"
 #include "ofxTimecode.h"
 
 //internal types
@@ -75,6 +80,8 @@
 
 typedef struct {
     ofxTLTrack* track;
+    //tracks that support undo deltas store their edit here, the rest store their xml in the state buffer
+    ofxTLUndoDelta* delta;
     string stateBuffer;
 } UndoItem;
 
@@ -90,12 +97,63 @@ class ofxTimeline : ofThread {
 
 	virtual void setup();
 	
+	//headless timelines load, play, sample and send events without a window or GL context,
+	//for render nodes without a display and for tests. call before setup()
+	//nothing is drawn, mouse and key events aren't listened to, the font is never loaded
+	//and tracks don't compute their previews. video and image sequence tracks still need GL
+	//it's only a runtime switch: the drawing and interface code is still compiled and linked
+	void setHeadless(bool headless);
+	bool getIsHeadless();
+	
 	//Optionally run ofxTimeline on the background thread
 	//this isn't necessary most of the time but
 	//for precise timing apps and input recording it'll greatly
 	//improve performance
 	virtual void moveToThread();
     virtual void removeFromThread();
+	//the background thread updates the time at this rate, 1000 ticks per second by default
+	void setThreadTickRate(double ticksPerSecond);
+	double getThreadTickRate();
+	//how closely the background thread's ticks have kept to their deadlines
+	ofxTLClockStats getThreadClockStats();
+	void resetThreadClockStats();
+	
+	//bangs and flags are normally sent from update once the playhead has passed them, so up to an update late
+	//precise bangs are queued lookaheadMillis ahead while playing and sent from a high priority thread
+	//right when they're due. bangFired listeners are then called on that thread, not the main one
+	void setPreciseBangs(bool usePreciseBangs, float lookaheadMillis = 50);
+	bool getPreciseBangs();
+	float getBangLookaheadMillis();
+	//how late bangs and flags have been sent, see ofxTLBangEventArgs::latenessMillis
+	ofxTLLatencyHistogram getBangLatency();
+	void resetBangLatency();
+	//bang tracks send their events through this, and schedule them with the scheduler when precise bangs are on
+	void sendBangEvent(ofxTLBangEventArgs& args);
+	void sendSwitchEvent(ofxTLSwitchEventArgs& args);
+	ofxTLBangScheduler& getBangScheduler();
+	
+	//bangFired and switched listeners are normally called right away on the thread sending them,
+	//which is the timeline's own after moveToThread() or the bang thread with precise bangs
+	//queued events are put in a lock free queue instead and their listeners called from dispatchQueuedEvents(),
+	//on whichever thread calls it, so listeners don't need locks and can't hold up the timeline
+	//playback events are always sent right away since the tracks rely on them
+	//growing the queue throws away what's in it, so set the size while stopped
+	//removing a track drops its queued events, so remove tracks from the thread that dispatches them
+	void setQueueEvents(bool queueEvents, int queueSize = 1024);
+	bool getQueueEvents();
+	//sends everything queued so far to the listeners and returns how many events were sent
+	int dispatchQueuedEvents();
+	//to pop the events yourself instead, and for the overflow and drop counts
+	ofxTLEventQueue& getEventQueue();
+	
+	//with snapshots on every track's value, switch state and color is sampled together after each update,
+	//once per tick when on a thread, so readers get the values from one moment without locking anything
+	//look a track's index up once with ofxTLSnapshot::getTrackIndex() and read by index from then on
+	void setPublishSnapshots(bool publishSnapshots);
+	bool getPublishSnapshots();
+	//copies the newest snapshot, false if none has been published yet. safe from any thread,
+	//and reusing the same snapshot object between calls saves allocating
+	bool getSnapshot(ofxTLSnapshot& snapshot);
 	
 	bool toggleEnabled();
     virtual void enable();
@@ -155,8 +213,14 @@ class ofxTimeline : ofThread {
     
     //loads calls load on all tracks from the given folder
     //really useful for setting up 'project' directories
+    //sends events().loadProgress as tracks finish and returns once they all have
     void loadTracksFromFolder(string folderPath);
     void saveTracksToFolder(string folderPath);
+	
+	//load tracks that support it on numThreads worker threads in loadTracksFromFolder
+	//the rest, like image sequences, still load on the main thread alongside them
+	void setLoadTracksInParallel(bool loadInParallel, int numThreads = 4);
+	bool getLoadTracksInParallel();
 
 		
     //timing setup functions
@@ -173,6 +237,7 @@ class ofxTimeline : ofThread {
 
     //frame based mode timelines will never skip frames, and will advance at the speed of openFrameworks
     //regardless of the FPS that you set the timeline to
+    //after moveToThread() there are no openFrameworks frames to follow, so frames advance at the timeline's FPS instead
     void setFrameBased(bool frameBased);
 	bool getIsFrameBased();
 
@@ -196,9 +261,27 @@ class ofxTimeline : ofThread {
 	virtual int getCurrentFrame();
 	virtual float getCurrentTime();
 	virtual long getCurrentTimeMillis();
+	//the playhead as of this moment rather than the last update, while playing from the timeline's clock
+	double getPreciseTimeMillis();
     virtual float getPercentComplete();
 	virtual string getCurrentTimecode();
 	virtual long getQuantizedTime(unsigned long long time, unsigned long long step);
+	
+	//offline rendering moves the playhead by hand instead of following the clock or the app's frames,
+	//so batch renders and tests come out the same every run and go as fast as the tracks can be sampled
+	//each step sends every bang, flag and switch it crossed, in time order, before it returns
+	//nothing is drawn, so the window is never touched
+	//playback stops and the timeline comes off its thread until endOffline(), which puts it back
+	void beginOffline(); //from the in point
+	void beginOffline(unsigned long long startMillis);
+	void endOffline();
+	bool getIsOffline();
+	//forward to a time, frame or by a fixed step for any other sample rate
+	//stepping backwards jumps there without sending anything
+	void stepToMillis(unsigned long long millis);
+	void stepToFrame(int frame);
+	void stepFrame();
+	void stepSeconds(double seconds);
     
     //internal tracks call this when the value has changed slightly
     //so that views can know if they need to update
@@ -290,6 +373,14 @@ class ofxTimeline : ofThread {
     void enableUndo(bool enabled);
     void undo();
     void redo();
+    //once the undo history holds more than this many bytes the oldest edits are forgotten, 32mb by default
+    void setUndoMemoryBudget(size_t bytes);
+    size_t getUndoMemoryBudget();
+    size_t getUndoMemoryUsage();
+    //edits to one track that only change keys the previous edit touched, within this many millis
+    //of it, are undone together, so holding down an arrow key to nudge is one undo. 0 turns it off
+    void setUndoCoalesceMillis(unsigned long long millis);
+    unsigned long long getUndoCoalesceMillis();
     
 	void setMovePlayheadOnDrag(bool updatePlayhead);
 	bool getMovePlayheadOnDrag();
@@ -331,6 +422,26 @@ class ofxTimeline : ofThread {
 	ofxTLTrack* getTrack(string name);
 	ofxTLPage* getPage(string pageName);
 	
+	//typed lookup for tracks read every frame: find the track once at setup and keep the pointer,
+	//so each read is a plain call instead of the name lookups getValue(name) and friends do
+	//the pointer stays good until the track is removed or the timeline is reset
+	//returns NULL and logs if there's no such track or it isn't a T
+	//	ofxTLCurves* brightness = timeline.getTrack<ofxTLCurves>("Brightness");
+	//	...
+	//	float b = brightness->getValue();
+	template<class T> T* getTrack(string name){
+		ofxTLTrack* track = findTrack(name);
+		if(track == NULL){
+			ofLogError("ofxTimeline -- Couldn't find track " + name);
+			return NULL;
+		}
+		T* typedTrack = dynamic_cast<T*>(track);
+		if(typedTrack == NULL){
+			ofLogError("ofxTimeline -- Track " + name + " is " + track->getTrackType() + ", not the type asked for");
+		}
+		return typedTrack;
+	}
+	
 	//adding tracks always adds to the current page
     ofxTLCurves* addCurves(string name, ofRange valueRange = ofRange(0,1.0), float defaultValue = 0);
 	ofxTLCurves* addCurves(string name, string xmlFileName, ofRange valueRange = ofRange(0,1.0), float defaultValue = 0);
@@ -463,13 +574,28 @@ class ofxTimeline : ofThread {
     
     virtual ofxTLEvents& events();
     
-	//binary test hack
+	//save every keyframe track added after this is set in the binary format instead of xml
 	bool curvesUseBinary;
 	
   protected:
 
     ofxTimecode timecode;
 	ofxMSATimer timer;
+	ofxTLClock threadClock;
+	bool preciseBangs;
+	float bangLookaheadMillis;
+	ofxTLBangScheduler bangScheduler;
+	ofxTLLatencyHistogram bangLatency;
+	ofMutex bangLatencyLock;
+	bool queueEvents;
+	ofxTLEventQueue eventQueue;
+	//held by the threads sending into eventQueue, and while it's reallocated or a removed track's events are taken out
+	//dispatching never takes it
+	ofMutex eventQueueLock;
+	bool publishSnapshots;
+	ofxTLSnapshotBuffer snapshots;
+	vector<ofxTLTrack*> snapshotTracks;
+	void publishSnapshot();
     ofxTLEvents timelineEvents;
     ofxTLColors colors;
 
@@ -481,6 +607,26 @@ class ofxTimeline : ofThread {
 	vector<ofxTLPage*> pages;
 	ofxTLPage* currentPage;
     map<string, ofxTLPage*> trackNameToPage;
+	//kept alongside trackNameToPage so name lookups don't go through the page
+	map<string, ofxTLTrack*> trackNameToTrack;
+	//one lookup that never adds to trackNameToTrack, NULL if there's no such track
+	ofxTLTrack* findTrack(const string& trackName);
+	//what the name based getters use. the cast is checked in debug builds and free in release ones
+	template<class T> T* findTrackAs(const string& trackName){
+		ofxTLTrack* track = findTrack(trackName);
+		if(track == NULL){
+			return NULL;
+		}
+		#ifdef NDEBUG
+		return static_cast<T*>(track);
+		#else
+		T* typedTrack = dynamic_cast<T*>(track);
+		if(typedTrack == NULL){
+			ofLogError("ofxTimeline -- Track " + trackName + " is " + track->getTrackType() + ", not the type asked for");
+		}
+		return typedTrack;
+		#endif
+	}
 
     ofxTLTrack* modalTrack;
     ofxTLTrack* timeControl;
@@ -489,8 +635,18 @@ class ofxTimeline : ofThread {
     string workingFolder; 
     
 	bool isSetup;
+	bool isHeadless;
 	bool usingEvents;
 	bool isOnThread;
+	
+	bool isOffline;
+	bool offlineWasOnThread;
+	double offlineTime; //kept apart from the float currentTime so long renders don't drift
+	int offlineFrame;
+	vector<ofxTLQueuedEvent> offlineEvents;
+	void stepOfflineTo(double seconds);
+	void sendOfflineEvents();
+	void jumpPlayhead();
 
 	//called when the name changes to setup the inout track, zoomer, ticker etc
 	void setupStandardElements();
@@ -503,10 +659,16 @@ class ofxTimeline : ofThread {
 	//one string per track
 	vector<string> pasteboard;
     
-    bool undoEnabled; //turn off undo if you don't need it, it'll take up a ton of memory
+    bool undoEnabled; //turn off undo if you don't need it
     void collectStateBuffers();
     void pushUndoStack();
-    void restoreToState(vector<UndoItem>& state);
+    //takes the tracks in state back, or forward again, and swaps the stored xml for the state it replaced
+    void restoreToState(vector<UndoItem>& state, bool undoing);
+    //ends the recordings that collectStateBuffers started without keeping them
+    void discardStateBuffers();
+    size_t getUndoStateMemory(vector<UndoItem>& state);
+    void deleteUndoState(vector<UndoItem>& state);
+    void clearUndoStack();
     
     //this is populated on mouse-down or key-down with all items that could potentially be modified
 	vector<UndoItem> stateBuffers; 
@@ -516,6 +678,10 @@ class ofxTimeline : ofThread {
     deque< vector<UndoItem> > undoStack;
     //the undo pointer points into the array and lets the user move through undo/redo actions
     int undoPointer;
+    size_t undoMemoryBudget;
+    size_t undoMemoryUsage;
+    unsigned long long undoCoalesceMillis;
+    unsigned long long lastUndoPushMillis;
     
 	bool movePlayheadOnDrag;
     bool snapToBPM;
@@ -573,6 +739,8 @@ class ofxTimeline : ofThread {
 
 	bool autosave;
 	bool unsavedChanges;
+	bool loadTracksInParallel;
+	int numLoadThreads;
 	bool headersAreEditable;
 	bool minimalHeaders;
 	bool footersHidden;